@@ -0,0 +1,69 @@
+import os
+import sys
+import time
+import argparse
+import tempfile
+import subprocess
+from pathlib import Path
+
+# Compile-time benchmark: one TU per struct width, each counting the members of a
+# generated aggregate (and with --names, extracting its member names). Reports wall time
+# and peak compiler memory per TU.
+
+MEMBER_TYPES = ["int", "double", "std::string", "std::vector<int>"]
+
+def generate_source(n, names):
+    lines = ['#include "tinyrefl/utils/reflection.hpp"', "", "struct Wide {"]
+    for i in range(n):
+        lines.append(f"    {MEMBER_TYPES[i % len(MEMBER_TYPES)]} m{i};")
+    lines.append("};")
+    lines.append("")
+    lines.append(f"static_assert(tinyrefl::detail::members_count_v<Wide> == {n});")
+    if names:
+        lines.append(f'static_assert(tinyrefl::detail::struct_members_to_array<Wide>()[{n - 1}] == "m{n - 1}");')
+    lines.append("")
+    return "\n".join(lines)
+
+def compile_once(cxx, include_dirs, defines, source):
+    cmd = [cxx, "-std=c++20", "-fsyntax-only"] + [f"-D{define}" for define in defines]
+    for include_dir in include_dirs:
+        cmd += ["-I", str(include_dir)]
+    cmd.append(str(source))
+
+    start = time.perf_counter()
+    process = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    # wait4 reports the resource usage of this compiler process alone
+    _, status, usage = os.wait4(process.pid, 0)
+    elapsed = time.perf_counter() - start
+    if os.waitstatus_to_exitcode(status) != 0:
+        sys.stderr.write(process.stderr.read().decode(errors="replace")[:2000])
+        raise RuntimeError("compilation failed: " + " ".join(cmd))
+    return elapsed, usage.ru_maxrss / 1024.0
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "g++"))
+    parser.add_argument("--root", default=str(Path(__file__).parent.resolve()),
+                        help="tree whose tinyrefl/ headers are measured")
+    parser.add_argument("--counts", default="8,32,64,128")
+    parser.add_argument("--repeat", type=int, default=3)
+    parser.add_argument("--names", action="store_true", help="also extract the member names")
+    parser.add_argument("-D", dest="defines", action="append", default=[],
+                        help="preprocessor definition, e.g. -D TINYREFL_MAX_MEMBER_COUNT=192")
+    args = parser.parse_args()
+
+    root = Path(args.root)
+    include_dirs = [root, root / "tinyrefl", root / "tinyrefl" / "thirdparty"]
+
+    print(f"{'members':>8} {'time (s)':>10} {'memory (MiB)':>14}")
+    with tempfile.TemporaryDirectory() as tmp:
+        for n in [int(c) for c in args.counts.split(",")]:
+            source = Path(tmp) / f"wide_{n}.cpp"
+            source.write_text(generate_source(n, args.names))
+            runs = [compile_once(args.cxx, include_dirs, args.defines, source) for _ in range(args.repeat)]
+            best_time = min(r[0] for r in runs)
+            peak_memory = max(r[1] for r in runs)
+            print(f"{n:>8} {best_time:>10.2f} {peak_memory:>14.1f}")
+
+if __name__ == "__main__":
+    main()
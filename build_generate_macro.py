@@ -2,12 +2,18 @@ def generate_macro_line(n):
     members = [f"m{i+1}" for i in range(n)]
     return f"GET_MEMBER_TUPLE_HELPER({n}, {', '.join(members)})"
 
-def generate_header_file(filename="./tinyrefl/utils/reflection_get_member_tuple_helper.hpp", max_count=255):
-    with open(filename, "w") as f:
-        f.write("// Auto-generated macro expansion for GET_MEMBER_TUPLE_HELPER\n")
-        f.write("#pragma once\n\n")
-        for i in range(1, max_count + 1):
-            f.write(generate_macro_line(i) + "\n")
+# Members 1..chunk_size go to the base header, every further chunk to its own header named
+# after its upper bound; reflection_get_tuple.hpp includes those only up to
+# TINYREFL_MAX_MEMBER_COUNT.
+def generate_header_files(directory="./tinyrefl/utils", max_count=256, chunk_size=64):
+    for first in range(1, max_count + 1, chunk_size):
+        last = min(first + chunk_size - 1, max_count)
+        suffix = "" if first == 1 else f"_{last}"
+        with open(f"{directory}/reflection_get_member_tuple_helper{suffix}.hpp", "w") as f:
+            f.write(f"// Auto-generated macro expansion for GET_MEMBER_TUPLE_HELPER, members {first} to {last}\n")
+            f.write("#pragma once\n\n")
+            for i in range(first, last + 1):
+                f.write(generate_macro_line(i) + "\n")
 
 if __name__ == "__main__":
-    generate_header_file()
+    generate_header_files()
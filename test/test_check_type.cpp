@@ -47,7 +47,7 @@ int main()
     // static_assert(tinyrefl::detail::is_int64<int64_t>, "int64_t should match");
     // static_assert(tinyrefl::detail::is_int64<uint64_t>, "uint64_t should match");
     static_assert(!tinyrefl::detail::is_int64_v<int32_t>, "int32_t should not match");
-    static_assert(!tinyrefl::detail::is_int64_v<long>, "long might not match on all platforms");
+    static_assert(tinyrefl::detail::is_int64_v<long> == std::is_same_v<long, int64_t>, "long might not match on all platforms");
     static_assert(!tinyrefl::detail::is_int64_v<float>, "float should not match");
     static_assert(!tinyrefl::detail::is_int64_v<void*>, "pointer should not match");
 
@@ -1,7 +1,60 @@
 #include "tinyrefl/utils/reflection.hpp"
+#include <string>
+#include <vector>
+
+struct WithArrays {
+	int id;
+	char name[16];
+	double matrix[2][3];
+	std::string tag;
+};
+
+struct Wide {
+	int m0, m1, m2, m3, m4, m5, m6, m7, m8, m9;
+	std::string s0, s1, s2, s3, s4, s5, s6, s7, s8, s9;
+	std::vector<int> v0, v1, v2, v3, v4, v5, v6, v7, v8, v9;
+	double d0, d1, d2, d3, d4, d5, d6, d7, d8, d9;
+};
+
+struct Empty {};
+
+// members after an array that can not be value-initialized
+struct ND {
+	ND(int) {}
+};
+
+struct NameAndRef {
+	char name[8];
+	const int& r;
+};
+
+struct ArrayThenND {
+	int a;
+	int arr[2];
+	ND nd;
+};
+
+struct ArrayRefInt {
+	double d[4];
+	int& r;
+	int x;
+};
+
+struct ArrayStringND {
+	int arr[3];
+	std::string s;
+	ND nd;
+};
 
 int main() {
 	// test get members count
 	static_assert(tinyrefl::detail::members_count_v<Person> == 3);
+	static_assert(tinyrefl::detail::members_count_v<WithArrays> == 4);
+	static_assert(tinyrefl::detail::members_count_v<Wide> == 40);
+	static_assert(tinyrefl::detail::members_count_v<Empty> == 0);
+	static_assert(tinyrefl::detail::members_count_v<NameAndRef> == 2);
+	static_assert(tinyrefl::detail::members_count_v<ArrayThenND> == 3);
+	static_assert(tinyrefl::detail::members_count_v<ArrayRefInt> == 3);
+	static_assert(tinyrefl::detail::members_count_v<ArrayStringND> == 3);
     return 0;
 }
\ No newline at end of file
@@ -1,54 +1,100 @@
 #include "tinyrefl/utils/reflection.hpp"
 
-#include <format>
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
 
-template <typename T, typename Tuple, size_t... Is>
-auto func(std::index_sequence<Is...>) {
-    using ValueType = decltype(tinyrefl::detail::get_variant_type<T, Tuple, Is...>());
-    return ValueType{};
+// no default constructor: offsets and names need no object
+struct Handle {
+    explicit Handle(int fd) : fd(fd) {}
+    int fd;
+};
+
+struct Record {
+    char tag;
+    double value;
+    std::string name;
+    Handle handle;
+    short flags[3];
+    std::vector<int> values;
+};
+
+// members moved away from where their types alone would put them
+struct Aligned {
+    int a;
+    alignas(16) int b;
+    int c;
+};
+
+struct AlignedInside {
+    char a;
+    alignas(2) char b;
+    int c;
+};
+
+#pragma pack(push, 1)
+struct Packed {
+    char a;
+    int b;
+    int c;
+};
+#pragma pack(pop)
+
+struct Tag {};
+
+struct Overlapped {
+    [[no_unique_address]] Tag tag;
+    int a;
+    int b;
+};
+
+template <typename T, std::size_t N>
+void check_offsets([[maybe_unused]] const std::size_t (&expected)[N]) {
+    const auto& offsets = tinyrefl::detail::struct_member_offset_array<T>();
+    static_assert(std::tuple_size_v<std::remove_cvref_t<decltype(offsets)>> == N);
+    for (std::size_t i = 0; i < N; ++i) {
+        assert(offsets[i] == expected[i]);
+    }
 }
 
 int main()
 {
-    auto& arr = tinyrefl::detail::struct_member_offset_array<Person>();
+    // offsets are taken from member addresses
+    const auto& arr = tinyrefl::detail::struct_member_offset_array<Person>();
+    check_offsets<Person>({ offsetof(Person, m_name), offsetof(Person, m_age), offsetof(Person, m_male) });
 
-    for (int i = 0; i < arr.size(); ++i) {
-        std::cout << std::format("{}: {}\n", i, arr[i]);
+    for (std::size_t i = 0; i < arr.size(); ++i) {
+        std::cout << i << ": " << arr[i] << "\n";
     }
 
-    std::cout << std::format("size: {}\n", sizeof std::string);
-    std::cout << std::format("size: {}\n", sizeof Person);
+    check_offsets<Record>({ offsetof(Record, tag), offsetof(Record, value), offsetof(Record, name),
+        offsetof(Record, handle), offsetof(Record, flags), offsetof(Record, values) });
+
+    check_offsets<Aligned>({ 0, 16, 20 });
+    check_offsets<AlignedInside>({ 0, 2, 4 });
+    check_offsets<Packed>({ 0, 1, 5 });
+    check_offsets<Overlapped>({ offsetof(Overlapped, tag), offsetof(Overlapped, a), offsetof(Overlapped, b) });
 
-    
-    std::cout << std::format("size: {}\n", sizeof tinyrefl::detail::Wrapper<Person>::value);
-    printf("address: %p\n", (char*)&tinyrefl::detail::Wrapper<Person>::value);
+    // names too
+    constexpr auto names = tinyrefl::detail::struct_members_to_array<Record>();
+    static_assert(names[3] == "handle" && names[5] == "values");
+
+    [[maybe_unused]] const auto& table = tinyrefl::detail::struct_member_offset_table<Person>();
+    assert(std::get<1>(table[1]).value == offsetof(Person, m_age));
 
-    printf("m_name address: %p\n", (char*)&tinyrefl::detail::Wrapper<Person>::value.m_name);
-    printf("m_age address: %p\n", (char*)&tinyrefl::detail::Wrapper<Person>::value.m_age);
-    printf("m_male address: %p\n", (char*)&tinyrefl::detail::Wrapper<Person>::value.m_male);
-    
     printf("\n------------\n");
 
     static auto member_offset_map = tinyrefl::detail::struct_member_offset_map<Person>();
     auto member_name_arr = tinyrefl::detail::struct_members_to_array<Person>();
 
-    for (int i = 0; i < member_offset_map.size(); ++i) {
-        auto it = member_offset_map.find(member_name_arr[i]);
-        std::cout << std::format("{}: {}\n", i, member_name_arr[i]);
+    for (std::size_t i = 0; i < member_offset_map.size(); ++i) {
+        auto it = member_offset_map.find(std::string(member_name_arr[i]));
+        std::cout << i << ": " << member_name_arr[i] << "\n";
         if (it != member_offset_map.end()) {
-            auto offset = it->second;
             std::visit([&](auto&& arg) {
-                // 将it->first转为std::string输出，按照string_view输出会出现输出与key不一致的情况
-                // 但是frozen::string不支持转换string, 正常string_view可以
-                printf("%s offset: %d\n", std::string(it->first.data()).c_str(), arg.value);
-            }, offset);
+                printf("%s offset: %zu\n", it->first.c_str(), arg.value);
+            }, it->second);
         }
     }
-
-    std::variant<int, float, double> var{std::in_place_index<1>, 0.5};
-    std::visit([&](auto&& value) {
-        // 此时value类型推导为float
-        std::cout << std::format("type name: {}\n", typeid(value).name());
-    }, var);
     return 0;
-}
\ No newline at end of file
+}
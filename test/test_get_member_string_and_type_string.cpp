@@ -1,20 +1,41 @@
+// wider structs than the default 64 members
+#define TINYREFL_MAX_MEMBER_COUNT 192
 #include "tinyrefl/utils/reflection.hpp"
 
 #include <array>
+
+struct Telemetry {
+	int f0, f1, f2, f3, f4, f5, f6, f7, f8, f9;
+	int f10, f11, f12, f13, f14, f15, f16, f17, f18, f19;
+	int f20, f21, f22, f23, f24, f25, f26, f27, f28, f29;
+	int f30, f31, f32, f33, f34, f35, f36, f37, f38, f39;
+	int f40, f41, f42, f43, f44, f45, f46, f47, f48, f49;
+	int f50, f51, f52, f53, f54, f55, f56, f57, f58, f59;
+	int f60, f61, f62, f63, f64, f65, f66, f67, f68, f69;
+	int f70, f71, f72, f73, f74, f75, f76, f77, f78, f79;
+	int f80, f81, f82, f83, f84, f85, f86, f87, f88, f89;
+	int f90, f91, f92, f93, f94, f95, f96, f97, f98, f99;
+	int f100, f101, f102, f103, f104, f105, f106, f107, f108, f109;
+	int f110, f111, f112, f113, f114, f115, f116, f117, f118, f119;
+	int f120, f121, f122, f123, f124, f125, f126, f127, f128, f129;
+	int f130, f131, f132, f133, f134, f135, f136, f137, f138, f139;
+	int f140, f141, f142, f143, f144, f145, f146, f147, f148, f149;
+};
+
 int main() {
     	// test get members name
-	constexpr auto tp_name = tinyrefl::detail::struct_members_to_tuple<Person>();
-	[&]<size_t... Is>(std::index_sequence<Is...> seq) {
-		((std::cout << tinyrefl::detail::get_member_name<&std::get<Is>(tp_name)>() << "\n"), ...);
-	}(std::make_index_sequence<std::tuple_size_v<decltype(tp_name)>>{});
+	// the tuple refers to an object that is never defined: use it in constant expressions only
+	using Tuple = decltype(tinyrefl::detail::struct_members_to_tuple<Person>());
+	[]<size_t... Is>(std::index_sequence<Is...> seq) {
+		((std::cout << tinyrefl::detail::get_member_name<&std::get<Is>(tinyrefl::detail::struct_members_to_tuple<Person>())>() << "\n"), ...);
+	}(std::make_index_sequence<std::tuple_size_v<Tuple>>{});
 
 	std::cout << "\n\n\n";
 
 	// test get members type
-	constexpr auto tp_tuple = tinyrefl::detail::struct_members_to_tuple<Person>();
-	[&]<size_t... Is>(std::index_sequence<Is...> seq) {
-		((std::cout << tinyrefl::detail::get_member_type_name<std::remove_const_t<std::remove_reference_t<decltype(std::get<Is>(tp_tuple))>>>() << "\n"), ...);
-	}(std::make_index_sequence<std::tuple_size_v<decltype(tp_tuple)>>{});
+	[]<size_t... Is>(std::index_sequence<Is...> seq) {
+		((std::cout << tinyrefl::detail::get_member_type_name<std::remove_const_t<std::remove_reference_t<std::tuple_element_t<Is, Tuple>>>>() << "\n"), ...);
+	}(std::make_index_sequence<std::tuple_size_v<Tuple>>{});
 
 	// test get member array
 	constexpr auto array = tinyrefl::detail::struct_members_to_array<Person>();
@@ -22,5 +43,14 @@ int main() {
 		std::cout << array[i] << "\n";
 	}
 
+	constexpr auto wide = tinyrefl::detail::struct_members_to_array<Telemetry>();
+	static_assert(wide.size() == 150);
+	static_assert(wide[0] == "f0" && wide[149] == "f149");
+
+	// names are views into one per-type blob of '\0' terminated names
+	using Table = tinyrefl::detail::member_name_table<Telemetry>;
+	static_assert(wide[1].data() == Table::blob.data() + 3);
+	static_assert(Table::offsets[150] == Table::blob.size());
+
     return 0;
 }
\ No newline at end of file
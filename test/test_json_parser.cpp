@@ -0,0 +1,570 @@
+#include "tinyrefl/reflection_to_json.hpp"
+#include "tinyrefl/reflection_from_json.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <span>
+#include <string_view>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+#include <climits>
+#include <new>
+#include <atomic>
+#include <cstdio>
+
+#include "rapidjson/filereadstream.h"
+
+// count heap allocations to check steady-state parsing
+static std::atomic<std::size_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+
+// kept out of line: inlined at a call site, GCC pairs the free with the builtin operator new
+// and warns about mismatched allocation functions
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete[](void* p) noexcept { ::operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { ::operator delete(p); }
+
+struct Request {
+    int request_identifier;
+    double requested_timeout_seconds;
+    bool include_extended_attributes;
+    std::string method;
+};
+
+struct Inner {
+    int id;
+    std::string label;
+};
+
+struct Batch {
+    std::string name;
+    std::vector<int> values;
+    std::vector<Inner> inner_list;
+    std::vector<std::vector<int>> matrix;
+};
+
+void test_overwrite() {
+    const char* large = R"({"name": "batch with a name longer than sso", "values": [1, 2, 3, 4, 5],
+        "inner_list": [{"id": 1, "label": "first label longer than sso"}, {"id": 2, "label": "b"}, {"id": 3, "label": "c"}],
+        "matrix": [[1, 2], [3, 4, 5]]})";
+    const char* small = R"({"name": "small", "values": [9],
+        "inner_list": [{"id": 7, "label": "x"}], "matrix": [[6], []]})";
+
+    // default mode appends to existing sequences
+    Batch appended{};
+    tinyrefl::reflection_from_json(appended, small);
+    tinyrefl::reflection_from_json(appended, small);
+    assert(appended.values.size() == 2 && appended.inner_list.size() == 2);
+
+    // overwrite mode replaces them, reading existing elements in place
+    Batch batch{};
+    auto st = tinyrefl::reflection_from_json<tinyrefl::kParseOverwriteFlag>(batch, large);
+    assert(st.ok && batch.values.size() == 5 && batch.inner_list.size() == 3);
+    st = tinyrefl::reflection_from_json<tinyrefl::kParseOverwriteFlag>(batch, small);
+    assert(st.ok && batch.name == "small");
+    assert(batch.values == std::vector<int>{9});
+    assert(batch.inner_list.size() == 1 && batch.inner_list[0].id == 7 && batch.inner_list[0].label == "x");
+    assert(batch.matrix.size() == 2 && batch.matrix[0] == std::vector<int>{6} && batch.matrix[1].empty());
+    st = tinyrefl::reflection_from_json<tinyrefl::kParseOverwriteFlag>(batch, R"({"values": [], "inner_list": [{"id": 1}, {"id": 2}]})");
+    assert(st.ok && batch.values.empty() && batch.inner_list.size() == 2 && batch.inner_list[1].id == 2);
+    // reused elements keep nothing from the previous message
+    assert(batch.inner_list[0].label.empty() && batch.inner_list[1].label.empty());
+    Batch reused{};
+    tinyrefl::reflection_from_json<tinyrefl::kParseOverwriteFlag>(reused, R"({"inner_list": [{"id": 1, "label": "secret-from-msg-A"}], "matrix": [[1, 2]]})");
+    [[maybe_unused]] const std::size_t label_capacity = reused.inner_list[0].label.capacity();
+    st = tinyrefl::reflection_from_json<tinyrefl::kParseOverwriteFlag>(reused, R"({"inner_list": [{"id": 2}], "matrix": [[3]]})");
+    assert(st.ok && reused.inner_list[0].id == 2 && reused.inner_list[0].label.empty());
+    assert(reused.inner_list[0].label.capacity() == label_capacity && reused.matrix[0] == std::vector<int>{3});
+
+    // long-lived object: after warm-up on the largest message nothing allocates
+    tinyrefl::json_parser<Batch, tinyrefl::kParseOverwriteFlag> parser;
+    Batch worker{};
+    parser.parse(worker, large);
+    std::size_t before = g_allocations;
+    for (int i = 0; i < 1000; ++i) {
+        parser.parse(worker, (i & 1) ? small : large);
+    }
+    std::size_t overwrite_allocations = g_allocations - before;
+    std::cout << "overwrite json_parser allocations: " << overwrite_allocations << "\n";
+    assert(overwrite_allocations == 0);
+    assert(worker.name == "small" && worker.inner_list.size() == 1);
+}
+
+void test_bounded() {
+    // two messages back to back in one receive buffer, no NUL terminator between them
+    const std::string receive = R"({"request_identifier": 1, "method": "PUT"}{"request_identifier": 2, "method": "POST"})";
+    const std::size_t split = receive.find('}') + 1;
+    std::string_view first(receive.data(), split);
+    std::span<const char> second(receive.data() + split, receive.size() - split);
+
+    Request request{};
+    auto st = tinyrefl::reflection_from_json(request, first);
+    assert(st.ok && request.request_identifier == 1 && request.method == "PUT");
+    st = tinyrefl::reflection_from_json(request, second);
+    assert(st.ok && request.request_identifier == 2 && request.method == "POST");
+
+    auto [ok, value] = tinyrefl::reflection_from_json<Request>(first);
+    assert(ok && value.method == "PUT");
+
+    tinyrefl::json_parser<Request> parser;
+    assert(parser.parse(request, first).ok && request.request_identifier == 1);
+    assert(parser.parse(request, second).ok && request.request_identifier == 2);
+
+    // a mutable receive buffer
+    std::string mutable_receive = receive;
+    std::span<char> buffer(mutable_receive.data() + split, mutable_receive.size() - split);
+    request = Request{};
+    assert(tinyrefl::reflection_from_json(request, buffer).ok && request.request_identifier == 2);
+    request = Request{};
+    assert(parser.parse(request, buffer).ok && request.method == "POST");
+    std::span<char, 0> nothing;
+    assert(!parser.parse(request, nothing).ok);
+
+    // the slice ends inside the message
+    st = parser.parse(request, std::string_view(receive.data(), split - 1));
+    assert(!st.ok && st.error.offset == split - 1);
+    // the whole buffer holds two roots
+    st = tinyrefl::reflection_from_json(request, std::string_view(receive));
+    assert(!st.ok && st.error.kind == tinyrefl::ErrorKind::ExtraDataAfterRoot);
+}
+
+struct Event {
+    int64_t sequence;
+    std::string_view kind;
+    const char* source;
+    std::string owned;
+    Inner inner;
+    std::vector<std::string_view> tags;
+};
+
+struct Tick {
+    int64_t sequence;
+    std::string_view symbol;
+    std::string_view venue;
+    const char* source;
+};
+
+void test_insitu() {
+    std::string buffer = R"({"sequence": 42, "kind": "tr\u00e9de\n", "source": "feed-a",
+        "owned": "copied", "inner": {"id": 3, "label": "x"}, "tags": ["a", "b\"c"], "unknown": "skipped"})";
+    Event event{};
+    auto st = tinyrefl::reflection_from_json_insitu(event, std::span<char>(buffer));
+    assert(st.ok && event.sequence == 42);
+    assert(event.kind == "tr\xc3\xa9" "de\n" && std::string(event.source) == "feed-a" && event.owned == "copied");
+    assert(event.tags.size() == 2 && event.tags[1] == "b\"c" && event.inner.label == "x");
+    [[maybe_unused]] const char* first = buffer.data();
+    [[maybe_unused]] const char* last = buffer.data() + buffer.size();
+    assert(event.kind.data() >= first && event.kind.data() < last);
+    assert(event.source >= first && event.source < last);
+
+    // views round trip through the writer
+    std::string out;
+    tinyrefl::reflection_to_json(event, out);
+    assert(out.find("\"kind\":\"tr\xc3\xa9" "de\\n\"") != std::string::npos);
+    assert(out.find(R"("source":"feed-a")") != std::string::npos);
+
+    // views are left untouched outside in situ parsing
+    Event copied{};
+    st = tinyrefl::reflection_from_json(copied, R"({"kind": "x", "source": null, "owned": "y"})");
+    assert(st.ok && copied.kind.empty() && copied.source == nullptr && copied.owned == "y");
+
+    // the document owns the buffer and reuses it
+    tinyrefl::json_document<Tick> document;
+    const char* tick = R"({"sequence": 1, "symbol": "ACME", "venue": "XNAS", "source": null})";
+    st = document.parse(tick);
+    assert(st.ok && document->symbol == "ACME" && document->venue == "XNAS" && document->source == nullptr);
+    std::size_t before = g_allocations;
+    for (int i = 0; i < 1000; ++i) {
+        document.parse(tick);
+    }
+    std::size_t document_allocations = g_allocations - before;
+    std::cout << "json_document allocations: " << document_allocations << "\n";
+    assert(document_allocations == 0);
+
+    tinyrefl::json_document<Tick> moved = std::move(document);
+    assert(moved.value().symbol == "ACME");
+
+    const std::size_t length = std::strlen(tick);
+    std::unique_ptr<char[]> owned(new char[length]);
+    std::memcpy(owned.get(), tick, length);
+    st = moved.parse(std::move(owned), length);
+    assert(st.ok && moved->venue == "XNAS");
+}
+
+void test_key_prediction() {
+    Batch batch{"batch", {1, 2}, {{1, "a"}, {2, "b"}}, {{1}, {2, 3}}};
+    std::string json;
+    tinyrefl::reflection_to_json(batch, json);
+
+    // writer output arrives in declaration order, every key is predicted
+    tinyrefl::json_parser<Batch, tinyrefl::kParseOverwriteFlag> parser;
+    Batch parsed{};
+    assert(parser.parse(parsed, json).ok && parsed.inner_list[1].label == "b");
+    assert(parser.stats().key_hits == 8 && parser.stats().key_misses == 0);
+
+    // unknown keys miss but keep the prediction for the next key
+    assert(parser.parse(parsed, R"({"name": "x", "extra": 1, "values": [4]})").ok);
+    assert(parsed.name == "x" && parser.stats().key_hits == 10 && parser.stats().key_misses == 1);
+
+    // reordered keys fall back to the key index
+    assert(parser.parse(parsed, R"({"values": [], "name": "y", "inner_list": []})").ok);
+    assert(parsed.name == "y" && parser.stats().key_hits == 10 && parser.stats().key_misses == 4);
+}
+
+void test_skip_unknown() {
+    // brackets and quotes inside skipped strings do not end the value
+    Request request{};
+    auto st = tinyrefl::reflection_from_json(request, R"({"unknown": {"a": ["]}", "\"{[", {"b": [[], {}]}], "c": "x\\"},
+        "more": "}", "request_identifier": 5})");
+    assert(st.ok && request.request_identifier == 5);
+
+    // mismatched member types are skipped the same way
+    st = tinyrefl::reflection_from_json(request, R"({"method": {"x": "]"}, "request_identifier": [6], "include_extended_attributes": true})");
+    assert(st.ok && request.request_identifier == 5 && request.include_extended_attributes);
+
+    // an unterminated unknown value fails at the end of the input
+    const std::string cut = R"({"unknown": {"a": [1, "}"], "b": 2, "request_identifier": 7})";
+    const std::size_t length = cut.find("\"b\"");
+    st = tinyrefl::reflection_from_json(request, std::string_view(cut.data(), length));
+    assert(!st.ok && st.error.offset == length && st.error.kind == tinyrefl::ErrorKind::SyntaxError);
+    st = tinyrefl::reflection_from_json(request, R"({"unknown": "abc)");
+    assert(!st.ok && st.error.kind == tinyrefl::ErrorKind::SyntaxError);
+
+    // skipped values are still validated
+    for (const char* malformed : {R"(xyz)", R"({"request_identifier": tru})", R"({"request_identifier": nul})",
+                                  R"({"zz": -})", R"({"zz": 1.2.3.4})", R"({"zz": {"a" 1 2 3}})",
+                                  R"({"zz": [1 2]})", R"({"zz": "\q"})", R"({"zz": 01})"}) {
+        st = tinyrefl::reflection_from_json(request, malformed);
+        assert(!st.ok);
+    }
+    tinyrefl::field_mask<Request> selected{"request_identifier"};
+    st = tinyrefl::reflection_from_json(request, R"({"request_identifier": 8, "zz": tru})", selected);
+    assert(!st.ok && st.error.kind == tinyrefl::ErrorKind::SyntaxError);
+    st = tinyrefl::reflection_from_json(request, R"({"request_identifier": 8, "zz": [true, null, -0.5e+3]})", selected);
+    assert(st.ok && request.request_identifier == 8);
+}
+
+void test_projection() {
+    const char* json = R"({"name": "batch", "values": [1, 2, 3], "inner_list": [{"id": 1, "label": "a"}],
+        "matrix": [[1], [2]]})";
+
+    // compile time projection
+    Batch batch{};
+    auto st = tinyrefl::reflection_from_json<Batch, tinyrefl::fields<"name", "matrix">>(batch, json);
+    assert(st.ok && batch.name == "batch" && batch.matrix.size() == 2);
+    assert(batch.values.empty() && batch.inner_list.empty());
+
+    auto [ok, projected] = tinyrefl::reflection_from_json<Batch, tinyrefl::fields<"values">>(json);
+    assert(ok && projected.values.size() == 3 && projected.name.empty());
+
+    constexpr auto mask = tinyrefl::detail::field_mask_v<Batch, tinyrefl::fields<"inner_list">>;
+    static_assert(mask.count() == 1 && mask.test(2));
+
+    // runtime mask, unknown names are reported by set()
+    tinyrefl::field_mask<Batch> runtime{"inner_list"};
+    assert(runtime.set("values") && !runtime.set("no_such_member") && runtime.count() == 2);
+    Batch masked{};
+    st = tinyrefl::reflection_from_json(masked, json, runtime);
+    assert(st.ok && masked.values.size() == 3 && masked.inner_list.size() == 1 && masked.name.empty());
+
+    // a repeated selected key doesn't end the scan before the other selected members
+    Batch repeated{};
+    st = tinyrefl::reflection_from_json(repeated, R"({"values": [1], "values": [2], "inner_list": [{"id": 3}]})", runtime);
+    assert(st.ok && repeated.values.size() == 2 && repeated.inner_list.size() == 1 && repeated.inner_list[0].id == 3);
+
+    // skipped members still have to be well formed enough to find their end
+    tinyrefl::json_parser<Batch> parser;
+    st = parser.parse(masked, R"({"name": "x", "values": [1, 2})", runtime);
+    assert(!st.ok);
+    // an empty mask reads nothing
+    Batch untouched{};
+    assert(parser.parse(untouched, json, tinyrefl::field_mask<Batch>{}).ok);
+    assert(untouched.name.empty() && untouched.values.empty() && untouched.matrix.empty());
+}
+
+struct Routes {
+    std::unordered_map<std::string, Inner> table;
+    std::map<std::string, std::vector<int>> ports;
+};
+
+void test_map() {
+    Routes routes{{{"/a", {1, "one"}}, {"/b\"q", {2, "two"}}}, {{"http", {80, 8080}}, {"empty", {}}}};
+    std::string json;
+    tinyrefl::reflection_to_json(routes, json);
+
+    Routes parsed{};
+    auto st = tinyrefl::reflection_from_json(parsed, json);
+    assert(st.ok);
+    assert(parsed.table.size() == 2 && parsed.table["/b\"q"].label == "two");
+    assert(parsed.ports == routes.ports);
+
+    // mismatched values are skipped, existing entries are kept and updated
+    st = tinyrefl::reflection_from_json(parsed, R"({"table": {"/a": {"id": 5}, "/c": 3, "/d": {}}})");
+    assert(st.ok && parsed.table.size() == 3 && parsed.table["/a"].id == 5 && parsed.table["/a"].label == "one");
+    assert(parsed.table.count("/c") == 0);
+
+    // updating existing keys builds no key strings
+    const std::string long_key = "/a route name longer than the small string buffer";
+    parsed.table[long_key] = {};
+    parsed.ports[long_key] = {};
+    const std::string update = R"({"table": {")" + long_key + R"(": {"id": 6}}, "ports": {")" + long_key + R"(": [1]}})";
+    tinyrefl::json_parser<Routes> routes_parser;
+    assert(routes_parser.parse(parsed, update).ok);
+    [[maybe_unused]] std::size_t before = g_allocations;
+    assert(routes_parser.parse(parsed, update).ok);
+    assert(g_allocations - before == 1);  // the appended port
+    assert(parsed.table[long_key].id == 6 && parsed.ports[long_key].size() == 2);
+    parsed.table.erase(long_key);
+    parsed.ports.erase(long_key);
+
+    // overwrite replaces the whole map
+    st = tinyrefl::reflection_from_json<tinyrefl::kParseOverwriteFlag>(parsed, R"({"table": {"/z": {"id": 9}}, "ports": {}})");
+    assert(st.ok && parsed.table.size() == 1 && parsed.table["/z"].id == 9 && parsed.ports.empty());
+
+    // the pre-scan counts top level members only, brackets and commas in strings are not members
+    [[maybe_unused]] const char* nested = R"({"a": [1, 2, 3], "b,}": [], "c\"{": [4]})";
+    assert(tinyrefl::detail::count_json_elements(nested + 1, nested + std::strlen(nested)) == 3);
+    Routes counted{};
+    assert(tinyrefl::reflection_from_json(counted, std::string(R"({"ports": )") + nested + "}").ok);
+    assert(counted.ports.size() == 3 && counted.ports["c\"{"].size() == 1);
+
+    st = tinyrefl::reflection_from_json(parsed, R"({"table": {"/a": {"id": 1}, }})");
+    assert(!st.ok);
+}
+
+struct Telemetry {
+    std::vector<int> values;
+    std::vector<double> samples;
+    std::vector<std::vector<int>> matrix;
+    std::vector<std::int64_t> stamps;
+};
+
+void test_number_arrays() {
+    Telemetry t{};
+    auto st = tinyrefl::reflection_from_json(t, R"({"values": [1, -2,3 ,-2147483648, 2147483647], "samples": [0.5, -1e-3, 2E2,
+        12345678901234567890, 1.7976931348623157e308, 4.9e-324, -0.0], "matrix": [[1, 2], [], [3]],
+        "stamps": [-9223372036854775808, 9223372036854775807]})");
+    assert(st.ok);
+    assert((t.values == std::vector<int>{1, -2, 3, INT_MIN, INT_MAX}));
+    assert(t.samples.size() == 7 && t.samples[1] == -1e-3 && t.samples[2] == 200.0 && t.samples[3] == 12345678901234567890.0);
+    assert(t.samples[4] == 1.7976931348623157e308 && t.samples[5] == 4.9e-324 && std::signbit(t.samples[6]));
+    assert((t.matrix == std::vector<std::vector<int>>{{1, 2}, {}, {3}}));
+    assert(t.stamps[0] == INT64_MIN && t.stamps[1] == INT64_MAX);
+
+    // fractions into ints and mismatched elements go through the general path mid run
+    st = tinyrefl::reflection_from_json<tinyrefl::kParseOverwriteFlag>(t, R"({"values": [1, 2.9, "x", 3, null, 4]})");
+    assert(st.ok && (t.values == std::vector<int>{1, 2, 3, 4}));
+
+    // errors are the ones of the general path
+    st = tinyrefl::reflection_from_json(t, R"({"values": [1, 2 3]})");
+    assert(!st.ok && st.error.offset == 17);
+    assert(!tinyrefl::reflection_from_json(t, R"({"values": [1, 02]})").ok);
+    assert(!tinyrefl::reflection_from_json(t, R"({"values": [1,]})").ok);
+    assert(!tinyrefl::reflection_from_json(t, R"({"samples": [1.]})").ok);
+    assert(!tinyrefl::reflection_from_json(t, R"({"samples": [1e999]})").ok);
+    assert(!tinyrefl::reflection_from_json(t, R"({"values": [1, 2)").ok);
+
+    // numbers the element type can not hold are errors, not wrapped
+    for (const char* too_big : {R"({"values": [1, 2147483648]})", R"({"values": [-2147483649]})",
+                                R"({"values": [1e10]})", R"({"values": [-3e9, 1]})"}) {
+        st = tinyrefl::reflection_from_json(t, too_big);
+        assert(!st.ok && st.error.kind == tinyrefl::ErrorKind::NumberOutOfRange);
+    }
+    Request request{};
+    for (const char* too_big : {R"({"request_identifier": 3000000000})", R"({"request_identifier": 1e30})",
+                                R"({"request_identifier": -1e19})", R"({"requested_timeout_seconds": 1e999})"}) {
+        st = tinyrefl::reflection_from_json(request, too_big);
+        assert(!st.ok && st.error.kind == tinyrefl::ErrorKind::NumberOutOfRange);
+    }
+    st = tinyrefl::reflection_from_json(request, R"({"request_identifier": 2147483647.9})");
+    assert(st.ok && request.request_identifier == INT_MAX);
+}
+
+void test_stream() {
+    // a root array streamed from a file through a buffer far smaller than the document
+    std::FILE* file = std::tmpfile();
+    assert(file);
+    std::string json = "[";
+    for (int i = 0; i < 1000; ++i) {
+        json += i ? ", " : "";
+        json += R"({"name": "batch )" + std::to_string(i) + R"(", "values": [)" + std::to_string(i) +
+                R"(, 1], "inner_list": [{"id": )" + std::to_string(i) + R"(, "label": "l"}], "matrix": []})";
+        if (i == 500) {
+            json += R"(, "mismatched element is skipped")";
+        }
+    }
+    json += "]\n";
+    std::fwrite(json.data(), 1, json.size(), file);
+    std::rewind(file);
+
+    char chunk[64];
+    rapidjson::FileReadStream is(file, chunk, sizeof(chunk));
+    auto batches = tinyrefl::json_stream<Batch>(is);
+    int count = 0;
+    for ([[maybe_unused]] Batch& batch : batches) {
+        assert(batch.name == "batch " + std::to_string(count));
+        assert(batch.values.size() == 2 && batch.values[0] == count);
+        assert(batch.inner_list.size() == 1 && batch.inner_list[0].id == count);
+        ++count;
+    }
+    assert(count == 1000 && batches.result().ok);
+
+    // elements read in place keep their capacity
+    std::rewind(file);
+    rapidjson::FileReadStream reuse(file, chunk, sizeof(chunk));
+    count = 0;
+    for ([[maybe_unused]] Batch& batch : tinyrefl::json_stream<Batch, tinyrefl::kParseOverwriteFlag>(reuse)) {
+        assert(batch.values.size() == 2 && batch.values[0] == count);
+        ++count;
+    }
+    assert(count == 1000);
+    std::fclose(file);
+
+    // a reused element keeps nothing from the previous one
+    const std::string sparse = R"([{"name": "a", "values": [1], "inner_list": [{"id": 1, "label": "l"}]}, {"name": "b"}])";
+    tinyrefl::detail::BufferStream ss(sparse.data(), sparse.size());
+    count = 0;
+    for ([[maybe_unused]] Batch& batch : tinyrefl::json_stream<Batch, tinyrefl::kParseOverwriteFlag>(ss)) {
+        assert(batch.name == (count ? "b" : "a"));
+        assert(batch.values.empty() == (count == 1) && batch.inner_list.empty() == (count == 1));
+        ++count;
+    }
+    assert(count == 2);
+
+    // elements before a syntax error are still yielded
+    const std::string broken = R"([{"name": "a"}, {"name": "b"} {"name": "c"}])";
+    tinyrefl::detail::BufferStream bs(broken.data(), broken.size());
+    auto partial = tinyrefl::json_stream<Batch>(bs);
+    count = 0;
+    for ([[maybe_unused]] Batch& batch : partial) {
+        assert(batch.name == (count ? "b" : "a"));
+        ++count;
+    }
+    assert(count == 2 && !partial.result().ok);
+    assert(partial.result().error.kind == tinyrefl::ErrorKind::SyntaxError);
+    assert(partial.result().error.offset == broken.find("{\"name\": \"c\""));
+
+    const std::string empty = " [ ] ";
+    tinyrefl::detail::BufferStream es(empty.data(), empty.size());
+    auto none = tinyrefl::json_stream<Batch>(es);
+    assert(none.begin() == none.end() && none.result().ok);
+
+    const std::string object = R"({"name": "a"})";
+    tinyrefl::detail::BufferStream os(object.data(), object.size());
+    auto root = tinyrefl::json_stream<Batch>(os);
+    assert(root.begin() == root.end() && !root.result().ok);
+}
+
+void test_ndjson() {
+    // a batch large enough to be cut into chunks, with malformed and blank lines in it
+    std::string ndjson;
+    std::vector<std::size_t> malformed;
+    const std::size_t line_count = 20000;
+    for (std::size_t i = 0; i < line_count; ++i) {
+        if (i % 997 == 3) {
+            malformed.push_back(i);
+            ndjson += R"({"request_identifier": )" + std::to_string(i) + R"(, "method": "GET")" + "\n";
+        }
+        else if (i % 1013 == 5) {
+            ndjson += "  \r\n";
+        }
+        else {
+            ndjson += R"({"request_identifier": )" + std::to_string(i) +
+                      R"(, "requested_timeout_seconds": 0.5, "method": "line )" + std::to_string(i) + "\"}\n";
+        }
+    }
+
+    for (unsigned threads : {1u, 3u, 8u, 0u}) {
+        std::vector<Request> requests;
+        auto st = tinyrefl::parse_ndjson(ndjson, requests, threads);
+        assert(!st.ok && st.lines == line_count);
+        assert(st.errors.size() == malformed.size());
+        for (std::size_t i = 0; i < malformed.size(); ++i) {
+            [[maybe_unused]] const auto& error = st.errors[i];
+            assert(error.index == malformed[i] && error.error.line == malformed[i] + 1);
+            assert(error.error.kind == tinyrefl::ErrorKind::SyntaxError);
+            assert(ndjson[error.error.offset - 1] == '"' && ndjson[error.error.offset] == '\n');
+        }
+        // every line that parsed, in line order
+        std::size_t expected = 0;
+        for ([[maybe_unused]] const Request& request : requests) {
+            while (expected % 997 == 3 || expected % 1013 == 5) {
+                ++expected;
+            }
+            assert(request.request_identifier == static_cast<int>(expected));
+            assert(request.method == "line " + std::to_string(expected));
+            ++expected;
+        }
+        assert(requests.size() + malformed.size() + line_count / 1013 + 1 == line_count);
+    }
+
+    // last line without a newline, results appended to existing ones
+    std::vector<Request> requests(1);
+    auto st = tinyrefl::parse_ndjson(R"({"request_identifier": 1})" "\n" R"({"request_identifier": 2})", requests, 2);
+    assert(st.ok && st.lines == 2 && requests.size() == 3 && requests[2].request_identifier == 2);
+    st = tinyrefl::parse_ndjson("", requests);
+    assert(st.ok && st.lines == 0 && requests.size() == 3);
+}
+
+int main() {
+    const char* json = R"({"request_identifier": 7, "requested_timeout_seconds": 1.5,
+        "include_extended_attributes": true, "method": "GET", "unrecognised_extension_field": [1, 2]})";
+
+    tinyrefl::json_parser<Request> parser;
+    Request request{};
+
+    auto st = parser.parse(request, json);
+    assert(st.ok);
+    assert(request.request_identifier == 7 && request.requested_timeout_seconds == 1.5);
+    assert(request.include_extended_attributes && request.method == "GET");
+
+    // warmed up: keys longer than the SSO buffer no longer allocate
+    std::size_t before = g_allocations;
+    for (int i = 0; i < 1000; ++i) {
+        parser.parse(request, json);
+    }
+    std::size_t parser_allocations = g_allocations - before;
+
+    before = g_allocations;
+    for (int i = 0; i < 1000; ++i) {
+        tinyrefl::reflection_from_json(request, json);
+    }
+    std::size_t free_function_allocations = g_allocations - before;
+
+    std::cout << "json_parser allocations: " << parser_allocations << "\n";
+    std::cout << "reflection_from_json allocations: " << free_function_allocations << "\n";
+    assert(parser_allocations == 0);
+
+    st = parser.parse(request, R"({"method": 1,})");
+    assert(!st.ok && st.error.kind == tinyrefl::ErrorKind::SyntaxError);
+    std::cout << st.error.message << " at " << st.error.line << ":" << st.error.column << "\n";
+
+    test_overwrite();
+    test_bounded();
+    test_insitu();
+    test_key_prediction();
+    test_skip_unknown();
+    test_projection();
+    test_map();
+    test_number_arrays();
+    test_stream();
+    test_ndjson();
+    return 0;
+}
@@ -0,0 +1,205 @@
+// perf_field_mask.cpp
+#include "tinyrefl/reflection_to_json.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cassert>
+
+// --------------------- wide struct, 60 members ---------------------
+
+struct Wide {
+    int field_0;
+    double field_1;
+    std::string field_2;
+    std::vector<int> field_3;
+    bool field_4;
+    int field_5;
+    double field_6;
+    std::string field_7;
+    std::vector<int> field_8;
+    bool field_9;
+    int field_10;
+    double field_11;
+    std::string field_12;
+    std::vector<int> field_13;
+    bool field_14;
+    int field_15;
+    double field_16;
+    std::string field_17;
+    std::vector<int> field_18;
+    bool field_19;
+    int field_20;
+    double field_21;
+    std::string field_22;
+    std::vector<int> field_23;
+    bool field_24;
+    int field_25;
+    double field_26;
+    std::string field_27;
+    std::vector<int> field_28;
+    bool field_29;
+    int field_30;
+    double field_31;
+    std::string field_32;
+    std::vector<int> field_33;
+    bool field_34;
+    int field_35;
+    double field_36;
+    std::string field_37;
+    std::vector<int> field_38;
+    bool field_39;
+    int field_40;
+    double field_41;
+    std::string field_42;
+    std::vector<int> field_43;
+    bool field_44;
+    int field_45;
+    double field_46;
+    std::string field_47;
+    std::vector<int> field_48;
+    bool field_49;
+    int field_50;
+    double field_51;
+    std::string field_52;
+    std::vector<int> field_53;
+    bool field_54;
+    int field_55;
+    double field_56;
+    std::string field_57;
+    std::vector<int> field_58;
+    bool field_59;
+};
+
+Wide MakeWide(std::size_t idx) {
+    Wide w{};
+    w.field_0 = static_cast<int>(idx * 1);
+    w.field_1 = static_cast<double>(idx) / 2.0;
+    w.field_2 = "value_2_" + std::to_string(idx);
+    w.field_3 = {1, 2, 3, static_cast<int>(idx)};
+    w.field_4 = (idx + 4) % 2 == 0;
+    w.field_5 = static_cast<int>(idx * 6);
+    w.field_6 = static_cast<double>(idx) / 7.0;
+    w.field_7 = "value_7_" + std::to_string(idx);
+    w.field_8 = {1, 2, 3, static_cast<int>(idx)};
+    w.field_9 = (idx + 9) % 2 == 0;
+    w.field_10 = static_cast<int>(idx * 11);
+    w.field_11 = static_cast<double>(idx) / 12.0;
+    w.field_12 = "value_12_" + std::to_string(idx);
+    w.field_13 = {1, 2, 3, static_cast<int>(idx)};
+    w.field_14 = (idx + 14) % 2 == 0;
+    w.field_15 = static_cast<int>(idx * 16);
+    w.field_16 = static_cast<double>(idx) / 17.0;
+    w.field_17 = "value_17_" + std::to_string(idx);
+    w.field_18 = {1, 2, 3, static_cast<int>(idx)};
+    w.field_19 = (idx + 19) % 2 == 0;
+    w.field_20 = static_cast<int>(idx * 21);
+    w.field_21 = static_cast<double>(idx) / 22.0;
+    w.field_22 = "value_22_" + std::to_string(idx);
+    w.field_23 = {1, 2, 3, static_cast<int>(idx)};
+    w.field_24 = (idx + 24) % 2 == 0;
+    w.field_25 = static_cast<int>(idx * 26);
+    w.field_26 = static_cast<double>(idx) / 27.0;
+    w.field_27 = "value_27_" + std::to_string(idx);
+    w.field_28 = {1, 2, 3, static_cast<int>(idx)};
+    w.field_29 = (idx + 29) % 2 == 0;
+    w.field_30 = static_cast<int>(idx * 31);
+    w.field_31 = static_cast<double>(idx) / 32.0;
+    w.field_32 = "value_32_" + std::to_string(idx);
+    w.field_33 = {1, 2, 3, static_cast<int>(idx)};
+    w.field_34 = (idx + 34) % 2 == 0;
+    w.field_35 = static_cast<int>(idx * 36);
+    w.field_36 = static_cast<double>(idx) / 37.0;
+    w.field_37 = "value_37_" + std::to_string(idx);
+    w.field_38 = {1, 2, 3, static_cast<int>(idx)};
+    w.field_39 = (idx + 39) % 2 == 0;
+    w.field_40 = static_cast<int>(idx * 41);
+    w.field_41 = static_cast<double>(idx) / 42.0;
+    w.field_42 = "value_42_" + std::to_string(idx);
+    w.field_43 = {1, 2, 3, static_cast<int>(idx)};
+    w.field_44 = (idx + 44) % 2 == 0;
+    w.field_45 = static_cast<int>(idx * 46);
+    w.field_46 = static_cast<double>(idx) / 47.0;
+    w.field_47 = "value_47_" + std::to_string(idx);
+    w.field_48 = {1, 2, 3, static_cast<int>(idx)};
+    w.field_49 = (idx + 49) % 2 == 0;
+    w.field_50 = static_cast<int>(idx * 51);
+    w.field_51 = static_cast<double>(idx) / 52.0;
+    w.field_52 = "value_52_" + std::to_string(idx);
+    w.field_53 = {1, 2, 3, static_cast<int>(idx)};
+    w.field_54 = (idx + 54) % 2 == 0;
+    w.field_55 = static_cast<int>(idx * 56);
+    w.field_56 = static_cast<double>(idx) / 57.0;
+    w.field_57 = "value_57_" + std::to_string(idx);
+    w.field_58 = {1, 2, 3, static_cast<int>(idx)};
+    w.field_59 = (idx + 59) % 2 == 0;
+    return w;
+}
+
+using Clock = std::chrono::high_resolution_clock;
+
+template <typename F>
+double MeasureMs(F&& fn) {
+    auto start = Clock::now();
+    fn();
+    auto end = Clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// every step-th member
+tinyrefl::field_mask<Wide> MakeMask(std::size_t step) {
+    tinyrefl::field_mask<Wide> mask;
+    for (std::size_t i = 0; i < 60; i += step) {
+        [[maybe_unused]] bool ok = mask.set("field_" + std::to_string(i));
+        assert(ok);
+    }
+    return mask;
+}
+
+int main() {
+    const std::size_t N_OBJECTS = 50000;
+
+    std::vector<Wide> objects;
+    objects.reserve(N_OBJECTS);
+    for (std::size_t i = 0; i < N_OBJECTS; ++i) {
+        objects.push_back(MakeWide(i));
+    }
+
+    std::cout << "TinyReflection field mask serialize benchmark (60 members)\n";
+    std::cout << "Objects: " << N_OBJECTS << "\n\n";
+
+    std::string out;
+    std::size_t bytes = 0;
+    // warm up the sink and the caches
+    for (auto& object : objects) {
+        out.clear();
+        tinyrefl::reflection_to_json(object, out);
+    }
+
+    double full_ms = MeasureMs([&] {
+        for (auto& object : objects) {
+            out.clear();
+            tinyrefl::reflection_to_json(object, out);
+            bytes += out.size();
+        }
+    });
+    std::cout << "all members (no mask): " << full_ms << " ms, "
+              << (N_OBJECTS * 1000.0) / full_ms << " objs/s\n";
+
+    const std::size_t steps[] = {10, 2, 1};
+    for (std::size_t step : steps) {
+        auto mask = MakeMask(step);
+        double ms = MeasureMs([&] {
+            for (auto& object : objects) {
+                out.clear();
+                tinyrefl::reflection_to_json(object, out, mask);
+                bytes += out.size();
+            }
+        });
+        std::cout << "mask " << mask.count() * 100 / 60 << "% (" << mask.count() << " members): " << ms << " ms, "
+                  << (N_OBJECTS * 1000.0) / ms << " objs/s, " << out.size() << " bytes\n";
+    }
+    std::cout << "bytes: " << bytes << "\n";
+    return 0;
+}
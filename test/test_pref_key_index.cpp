@@ -0,0 +1,144 @@
+// perf_key_index.cpp
+#include "tinyrefl/utils/reflection_key_index.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cassert>
+
+// --------------------- test structs (same as test_pref_reflection) ---------------------
+
+struct Inner {
+    int id;
+    std::string label;
+};
+
+struct Config {
+    bool flag;
+    double ratio;
+    std::vector<int> values;
+    Inner inner;
+    std::vector<Inner> inner_list;
+};
+
+struct Complex {
+    std::string name;
+    Config config;
+    std::vector<std::vector<int>> matrix;
+    std::vector<std::vector<Inner>> inner_matrix;
+};
+
+// --------------------- key stream ---------------------
+
+struct KeySlice {
+    const char* str;
+    std::size_t length;
+    int type;   // 0: Complex, 1: Config, 2: Inner
+};
+
+// keys in the order a serialized Complex delivers them, stored back to back without NUL terminators
+std::vector<KeySlice> MakeKeyStream(std::string& storage) {
+    std::vector<std::pair<std::string, int>> keys = {
+        {"name", 0}, {"config", 0},
+        {"flag", 1}, {"ratio", 1}, {"values", 1}, {"inner", 1},
+        {"id", 2}, {"label", 2},
+        {"inner_list", 1},
+    };
+    for (int i = 0; i < 5; ++i) {
+        keys.push_back({"id", 2});
+        keys.push_back({"label", 2});
+    }
+    keys.push_back({"matrix", 0});
+    keys.push_back({"inner_matrix", 0});
+    for (int i = 0; i < 4; ++i) {
+        keys.push_back({"id", 2});
+        keys.push_back({"label", 2});
+    }
+
+    for (auto& [key, type] : keys) {
+        storage += key;
+    }
+    std::vector<KeySlice> slices;
+    std::size_t offset = 0;
+    for (auto& [key, type] : keys) {
+        slices.push_back({storage.data() + offset, key.size(), type});
+        offset += key.size();
+    }
+    return slices;
+}
+
+using Clock = std::chrono::high_resolution_clock;
+
+template <typename F>
+double MeasureMs(F&& fn) {
+    auto start = Clock::now();
+    fn();
+    auto end = Clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main() {
+    const std::size_t N_ROUNDS = 2000000;
+
+    std::string storage;
+    auto slices = MakeKeyStream(storage);
+    const double total_keys = static_cast<double>(N_ROUNDS) * slices.size();
+
+    // check both lookups agree
+    auto complex_map = tinyrefl::detail::struct_member_offset_map<Complex>();
+    auto config_map = tinyrefl::detail::struct_member_offset_map<Config>();
+    auto inner_map = tinyrefl::detail::struct_member_offset_map<Inner>();
+    constexpr auto& complex_index = tinyrefl::detail::member_key_index_v<Complex>;
+    constexpr auto& config_index = tinyrefl::detail::member_key_index_v<Config>;
+    constexpr auto& inner_index = tinyrefl::detail::member_key_index_v<Inner>;
+    static_assert(complex_index.find("config") == 1);
+    static_assert(config_index.find("inner_list") == 4);
+    static_assert(inner_index.find("labe") == 2);
+
+    for (auto& slice : slices) {
+        std::string key(slice.str, slice.length);
+        switch (slice.type) {
+            case 0: assert(complex_index.find(slice.str, slice.length) < 4 && complex_map.count(key)); break;
+            case 1: assert(config_index.find(slice.str, slice.length) < 5 && config_map.count(key)); break;
+            default: assert(inner_index.find(slice.str, slice.length) < 2 && inner_map.count(key)); break;
+        }
+    }
+
+    std::cout << "TinyReflection key dispatch benchmark (Complex)\n";
+    std::cout << "Keys: " << static_cast<std::size_t>(total_keys) << "\n\n";
+
+    // before: std::string key + std::unordered_map lookup
+    std::size_t found = 0;
+    double map_ms = MeasureMs([&] {
+        for (std::size_t r = 0; r < N_ROUNDS; ++r) {
+            for (auto& slice : slices) {
+                switch (slice.type) {
+                    case 0: found += complex_map.find(std::string(slice.str, slice.length)) != complex_map.end(); break;
+                    case 1: found += config_map.find(std::string(slice.str, slice.length)) != config_map.end(); break;
+                    default: found += inner_map.find(std::string(slice.str, slice.length)) != inner_map.end(); break;
+                }
+            }
+        }
+    });
+
+    // after: compile-time perfect hash on (str, length)
+    double index_ms = MeasureMs([&] {
+        for (std::size_t r = 0; r < N_ROUNDS; ++r) {
+            for (auto& slice : slices) {
+                switch (slice.type) {
+                    case 0: found += complex_index.find(slice.str, slice.length) < 4; break;
+                    case 1: found += config_index.find(slice.str, slice.length) < 5; break;
+                    default: found += inner_index.find(slice.str, slice.length) < 2; break;
+                }
+            }
+        }
+    });
+
+    std::cout << "unordered_map<std::string>: " << map_ms << " ms, "
+              << total_keys * 1000.0 / map_ms << " keys/s\n";
+    std::cout << "member_key_index_v:         " << index_ms << " ms, "
+              << total_keys * 1000.0 / index_ms << " keys/s\n";
+    std::cout << "found: " << found << "\n";
+    return 0;
+}
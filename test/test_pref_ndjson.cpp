@@ -0,0 +1,141 @@
+// perf_ndjson.cpp
+#include "tinyrefl/reflection_to_json.hpp"
+#include "tinyrefl/reflection_from_json.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cassert>
+#include <algorithm>
+#include <span>
+
+// --------------------- 测试用结构体 ---------------------
+
+struct Inner {
+    int id;
+    std::string label;
+};
+
+struct Config {
+    bool flag;
+    double ratio;
+    std::vector<int> values;
+    Inner inner;
+    std::vector<Inner> inner_list;
+};
+
+struct Complex {
+    std::string name;
+    Config config;
+    std::vector<std::vector<int>> matrix;
+    std::vector<std::vector<Inner>> inner_matrix;
+};
+
+Complex MakeComplex(std::size_t idx) {
+    Complex obj;
+    obj.name = "Complex_" + std::to_string(idx);
+    obj.config.flag = (idx % 2 == 0);
+    obj.config.ratio = 3.14 + static_cast<double>(idx) * 0.001;
+    for (int i = 0; i < 10; ++i) {
+        obj.config.values.push_back(static_cast<int>(idx * 10 + i));
+    }
+    obj.config.inner = {static_cast<int>(idx), "Inner_" + std::to_string(idx)};
+    for (int i = 0; i < 5; ++i) {
+        obj.config.inner_list.push_back({static_cast<int>(idx * 100 + i), "List_" + std::to_string(i)});
+    }
+    obj.matrix.assign(3, std::vector<int>(3, static_cast<int>(idx)));
+    obj.inner_matrix.assign(2, std::vector<Inner>(2, Inner{static_cast<int>(idx), "M"}));
+    return obj;
+}
+
+using Clock = std::chrono::high_resolution_clock;
+
+template <typename F>
+double MeasureMs(F&& fn) {
+    auto start = Clock::now();
+    fn();
+    auto end = Clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main() {
+    const std::size_t N_OBJECTS = 200000;
+    const unsigned max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::vector<Complex> objects;
+    objects.reserve(N_OBJECTS);
+    for (std::size_t i = 0; i < N_OBJECTS; ++i) {
+        objects.push_back(MakeComplex(i));
+    }
+
+    // reference output, one object at a time
+    std::string expected;
+    for (const auto& obj : objects) {
+        tinyrefl::reflection_to_json(obj, expected);
+        expected.push_back('\n');
+    }
+
+    // more workers than cores still stitch the chunks in order
+    {
+        const std::span<const Complex> head(objects.data(), 10000);
+        std::string out;
+        tinyrefl::to_ndjson(head, out, 7);
+        assert(out == expected.substr(0, out.size()) && expected[out.size() - 1] == '\n');
+        assert(std::count(out.begin(), out.end(), '\n') == 10000);
+    }
+
+    std::cout << "to_ndjson / parse_ndjson scaling, " << N_OBJECTS << " objects, "
+              << expected.size() / (1024 * 1024) << " MiB\n";
+
+    double serialize_base = 0.0;
+    double parse_base = 0.0;
+    for (unsigned threads = 1;; threads = std::min(threads * 2, max_threads)) {
+        std::string out;
+        const double serialize_ms = MeasureMs([&] {
+            tinyrefl::to_ndjson<Complex>(objects, out, threads);
+        });
+        assert(out == expected);
+
+        std::vector<Complex> parsed;
+        tinyrefl::ndjson_status st;
+        const double parse_ms = MeasureMs([&] {
+            st = tinyrefl::parse_ndjson(out, parsed, threads);
+        });
+        assert(st.ok && st.lines == N_OBJECTS && parsed.size() == N_OBJECTS);
+        assert(parsed.back().name == objects.back().name && parsed.back().config.values == objects.back().config.values);
+
+        if (threads == 1) {
+            serialize_base = serialize_ms;
+            parse_base = parse_ms;
+        }
+        std::cout << "threads " << threads
+                  << "  serialize: " << serialize_ms << " ms (x" << serialize_base / serialize_ms << ")"
+                  << "  parse: " << parse_ms << " ms (x" << parse_base / parse_ms << ")\n";
+        if (threads == max_threads) {
+            break;
+        }
+    }
+
+#if defined(TINYREFL_HAS_WRITEV)
+    // gather the chunks straight into a file
+    std::FILE* file = std::tmpfile();
+    assert(file);
+    tinyrefl::fd_writer writer(fileno(file));
+    const double write_ms = MeasureMs([&] {
+        tinyrefl::to_ndjson<Complex>(objects, writer, max_threads);
+    });
+    assert(writer.good() && writer.written() == expected.size());
+
+    std::string written(expected.size(), '\0');
+    std::rewind(file);
+    assert(std::fread(written.data(), 1, written.size(), file) == written.size());
+    assert(written == expected);
+    std::fclose(file);
+    std::cout << "threads " << max_threads << "  serialize to file with writev: " << write_ms << " ms\n";
+#endif
+
+    return 0;
+}
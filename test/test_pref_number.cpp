@@ -0,0 +1,130 @@
+// perf_number.cpp
+#include "tinyrefl/reflection_to_json.hpp"
+#include "tinyrefl/reflection_from_json.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cassert>
+#include <cstdint>
+
+// --------------------- number heavy struct ---------------------
+
+struct Sample {
+    int64_t timestamp;
+    int channel;
+    unsigned int flags;
+    double x;
+    double y;
+    double z;
+    float gain;
+    std::vector<double> series;
+    std::vector<int> counts;
+};
+
+Sample MakeSample(std::size_t idx) {
+    Sample s;
+    s.timestamp = 1700000000000LL + static_cast<int64_t>(idx) * 37;
+    s.channel = static_cast<int>(idx % 64) - 32;
+    s.flags = static_cast<unsigned int>(idx * 2654435761u);
+    s.x = 3.1415926535 * static_cast<double>(idx);
+    s.y = -1.0 / static_cast<double>(idx + 3);
+    s.z = 1e-7 * static_cast<double>(idx) + 6.02214076e23;
+    s.gain = 0.1f * static_cast<float>(idx % 100);
+    for (int i = 0; i < 16; ++i) {
+        s.series.push_back(static_cast<double>(idx + i) / 7.0);
+        s.counts.push_back(static_cast<int>((idx * 31 + i) % 100000) - 5000);
+    }
+    return s;
+}
+
+// long runs of numbers, parsed by the vector<number> kernel
+struct Series {
+    std::vector<int> values;
+    std::vector<double> samples;
+    std::vector<std::vector<int>> matrix;
+};
+
+using Clock = std::chrono::high_resolution_clock;
+
+template <typename F>
+double MeasureMs(F&& fn) {
+    auto start = Clock::now();
+    fn();
+    auto end = Clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main() {
+    const std::size_t N_OBJECTS = 200000;
+
+    std::vector<Sample> samples;
+    samples.reserve(N_OBJECTS);
+    for (std::size_t i = 0; i < N_OBJECTS; ++i) {
+        samples.push_back(MakeSample(i));
+    }
+
+    std::cout << "TinyReflection number serialize benchmark\n";
+    std::cout << "Objects: " << N_OBJECTS << "\n\n";
+
+    std::vector<std::string> jsonStrings(N_OBJECTS);
+    double elapsed = MeasureMs([&] {
+        for (std::size_t i = 0; i < N_OBJECTS; ++i) {
+            tinyrefl::reflection_to_json(samples[i], jsonStrings[i]);
+        }
+    });
+
+    std::cout << "Serialize: " << elapsed << " ms, "
+              << (N_OBJECTS * 1000.0) / elapsed << " objs/s\n";
+    std::cout << "Sample: " << jsonStrings[7] << "\n";
+
+    // round trip check
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i < N_OBJECTS; i += 97) {
+        auto [ok, res] = tinyrefl::reflection_from_json<Sample>(jsonStrings[i].c_str());
+        const auto& s = samples[i];
+        if (!ok || res.x != s.x || res.y != s.y || res.z != s.z || res.gain != s.gain ||
+            res.timestamp != s.timestamp || res.flags != s.flags || res.series != s.series ||
+            res.counts != s.counts) {
+            ++mismatches;
+        }
+    }
+    std::cout << "Round trip mismatches: " << mismatches << "\n";
+
+    tinyrefl::json_parser<Sample, tinyrefl::kParseOverwriteFlag> parser;
+    Sample parsed;
+    elapsed = MeasureMs([&] {
+        for (std::size_t i = 0; i < N_OBJECTS; ++i) {
+            parser.parse(parsed, jsonStrings[i]);
+        }
+    });
+    std::cout << "Deserialize: " << elapsed << " ms, "
+              << (N_OBJECTS * 1000.0) / elapsed << " objs/s\n\n";
+
+    Series series;
+    for (std::size_t i = 0; i < 1000000; ++i) {
+        series.values.push_back(static_cast<int>(i * 2654435761u % 2000000) - 1000000);
+        series.samples.push_back(static_cast<double>(i % 20000) / 1000.0 - 10.0);
+    }
+    for (std::size_t r = 0; r < 10000; ++r) {
+        series.matrix.emplace_back();
+        for (std::size_t c = 0; c < 100; ++c) {
+            series.matrix.back().push_back(static_cast<int>((r * 131 + c * 7) % 1000));
+        }
+    }
+    std::string seriesJson;
+    tinyrefl::reflection_to_json(series, seriesJson);
+
+    Series seriesParsed;
+    elapsed = MeasureMs([&] {
+        auto st = tinyrefl::reflection_from_json(seriesParsed, seriesJson);
+        assert(st.ok);
+    });
+    std::cout << "Numeric arrays: " << seriesJson.size() / 1e6 << " MB in " << elapsed << " ms, "
+              << seriesJson.size() / elapsed / 1e3 << " MB/s\n";
+    std::cout << "Numeric arrays match: " << std::boolalpha
+              << (seriesParsed.values == series.values && seriesParsed.samples == series.samples &&
+                  seriesParsed.matrix == series.matrix) << "\n";
+    return 0;
+}
@@ -0,0 +1,80 @@
+// perf_skip.cpp
+#include "tinyrefl/reflection_from_json.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cassert>
+
+// --------------------- upstream document, we keep 2 of its fields ---------------------
+
+struct Kept {
+    int64_t id;
+    std::string status;
+};
+
+std::string MakeUpstream(std::size_t idx) {
+    std::string json = "{\"id\":" + std::to_string(idx) + ",\"payload\":{\"items\":[";
+    for (int i = 0; i < 20; ++i) {
+        json += (i ? "," : "");
+        json += "{\"sku\":\"SKU-" + std::to_string(idx * 20 + i) + "\",\"price\":" + std::to_string(i * 1.25) +
+                ",\"tags\":[\"a\",\"b\\\"]\",\"{c}\"],\"dims\":{\"w\":1,\"h\":2,\"d\":[3,4,5]},\"note\":null}";
+    }
+    json += "],\"meta\":{\"source\":\"upstream\",\"flags\":[true,false,true]}},";
+    json += "\"history\":[[1,2,3],[4,5,6],{\"k\":\"v\"}],\"status\":\"ok\"}";
+    return json;
+}
+
+using Clock = std::chrono::high_resolution_clock;
+
+template <typename F>
+double MeasureMs(F&& fn) {
+    auto start = Clock::now();
+    fn();
+    auto end = Clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main() {
+    const std::size_t N_OBJECTS = 20000;
+
+    std::vector<std::string> docs;
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < N_OBJECTS; ++i) {
+        docs.push_back(MakeUpstream(i));
+        bytes += docs.back().size();
+    }
+
+    std::cout << "TinyReflection unknown value skip benchmark\n";
+    std::cout << "Objects: " << N_OBJECTS << ", bytes: " << bytes << "\n\n";
+
+    // before: unknown values walked token by token (validating, any input stream)
+    Kept kept{};
+    std::size_t checksum = 0;
+    tinyrefl::detail::JsonReader<::rapidjson::StringStream> token_reader;
+    double token_ms = MeasureMs([&] {
+        for (auto& doc : docs) {
+            ::rapidjson::StringStream ss(doc.c_str());
+            [[maybe_unused]] bool ok = token_reader.parse(ss, kept);
+            assert(ok);
+            checksum += kept.id + kept.status.size();
+        }
+    });
+
+    // after: grammar check straight over the contiguous buffer, nothing decoded
+    tinyrefl::json_parser<Kept> parser;
+    double scan_ms = MeasureMs([&] {
+        for (auto& doc : docs) {
+            auto st = parser.parse(kept, std::string_view(doc));
+            assert(st.ok);
+            checksum += kept.id + kept.status.size();
+        }
+    });
+    assert(kept.id == static_cast<int64_t>(N_OBJECTS - 1) && kept.status == "ok");
+
+    std::cout << "token walk: " << token_ms << " ms, " << bytes / token_ms / 1000.0 << " MB/s\n";
+    std::cout << "scanner:    " << scan_ms << " ms, " << bytes / scan_ms / 1000.0 << " MB/s\n";
+    std::cout << "checksum: " << checksum << "\n";
+    return 0;
+}
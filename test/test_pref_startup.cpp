@@ -0,0 +1,87 @@
+// perf_startup.cpp
+#include "tinyrefl/reflection_to_json.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <utility>
+#include <cstdlib>
+#include <new>
+
+// --------------------- heap and constructor use before main ---------------------
+
+static std::size_t g_allocations = 0;
+static std::size_t g_allocated_bytes = 0;
+static std::size_t g_constructed = 0;
+
+void* operator new(std::size_t size) {
+    ++g_allocations;
+    g_allocated_bytes += size;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// a member that is costly to default construct
+struct Tracked {
+    Tracked() : payload(256, 'x') { ++g_constructed; }
+    std::string payload;
+};
+
+// 500 distinct reflected types
+template <std::size_t N>
+struct Synthetic {
+    std::size_t id;
+    std::string name;
+    std::vector<int> values;
+    Tracked tracked;
+    double ratio;
+};
+
+constexpr std::size_t N_TYPES = 500;
+
+template <std::size_t... Is>
+std::size_t ReflectAll(std::index_sequence<Is...>) {
+    std::size_t names = 0;
+    ((names += tinyrefl::detail::struct_members_to_array<Synthetic<Is>>().size()), ...);
+    return names;
+}
+
+using Clock = std::chrono::high_resolution_clock;
+
+// runs before every other dynamic initializer
+struct InitClock {
+    Clock::time_point at = Clock::now();
+};
+
+#if defined(__GNUC__)
+__attribute__((init_priority(101)))
+#endif
+static InitClock g_init_start;
+
+int main() {
+    const auto main_entered = Clock::now();
+    const std::size_t constructed_before_main = g_constructed;
+    const std::size_t allocations_before_main = g_allocations;
+    const std::size_t bytes_before_main = g_allocated_bytes;
+
+    auto start = Clock::now();
+    const std::size_t names = ReflectAll(std::make_index_sequence<N_TYPES>{});
+    auto end = Clock::now();
+
+    std::cout << "TinyReflection startup benchmark, " << N_TYPES << " reflected types\n";
+    std::cout << "dynamic initialization: "
+              << std::chrono::duration<double, std::micro>(main_entered - g_init_start.at).count() << " us\n";
+    std::cout << "objects constructed before main: " << constructed_before_main << "\n";
+    std::cout << "heap allocations before main: " << allocations_before_main
+              << " (" << bytes_before_main << " bytes)\n";
+    std::cout << "member names: " << names << " in "
+              << std::chrono::duration<double, std::micro>(end - start).count() << " us\n";
+
+    return 0;
+}
@@ -82,8 +82,42 @@ void test() {
     }
 }
 
+void test_skip_and_escape() {
+    const char* json = R"({
+        "unknown": {"a": [1, {"b": null}, "x\"y"], "c": -1.5e3},
+        "name": "tab\tquote\"\u00e9\ud83d\ude00",
+        "config": {"flag": false, "ratio": 2, "values": [1, "skip", 2, null, 3], "extra": [[]]},
+        "matrix": null
+    })";
+
+    auto [ok, res] = tinyrefl::reflection_from_json<Complex>(json);
+    assert(ok);
+    assert(res.name == "tab\tquote\"\xc3\xa9\xf0\x9f\x98\x80");
+    assert(res.config.flag == false);
+    assert(res.config.ratio == 2.0);
+    assert((res.config.values == vector<int>{1, 2, 3}));
+    assert(res.matrix.empty());
+    std::cout << "Skip And Escape Success!\n" << std::endl;
+}
+
+void test_error() {
+    Complex obj;
+    auto st = tinyrefl::reflection_from_json(obj, "{\n  \"name\": \"a\",\n  \"config\": {\"flag\": tru}\n}");
+    assert(!st.ok);
+    assert(st.error.kind == tinyrefl::ErrorKind::SyntaxError);
+    assert(st.error.line == 3);
+    std::cout << st.error.message << " at " << st.error.line << ":" << st.error.column << "\n" << std::endl;
+
+    assert(tinyrefl::reflection_from_json(obj, "   ").error.kind == tinyrefl::ErrorKind::Incomplete);
+    assert(tinyrefl::reflection_from_json(obj, "{} {}").error.kind == tinyrefl::ErrorKind::ExtraDataAfterRoot);
+    assert(tinyrefl::reflection_from_json(obj, "{\"name\": \"\\q\"}").error.kind == tinyrefl::ErrorKind::StringEscapeInvalid);
+    assert(tinyrefl::reflection_from_json(obj, "{\"config\": {\"ratio\": 1e999}}").error.kind == tinyrefl::ErrorKind::NumberOutOfRange);
+}
+
 int main() {
     
     test();
+    test_skip_and_escape();
+    test_error();
     return 0;
 }
@@ -1,6 +1,7 @@
 #include "tinyrefl/reflection_to_json.hpp"
 
 #include <iostream>
+#include <cassert>
 
 struct BasicTypes {
     int m_int;
@@ -85,6 +86,62 @@ int main() {
     empty.m_basic.m_cstr = nullptr;
     tinyrefl::reflection_to_json(empty, output);
     std::cout << output << std::endl;
-    
+
+    output.clear();
+    std::cout << "--- Escape ---" << std::endl;
+    BasicTypes escaped {1, 0.5f, 0.25, '"', "tab\there", "line\nbreak \"quoted\" back\\slash \x01 and a long clean run of text", true};
+    tinyrefl::reflection_to_json(escaped, output);
+    std::cout << output << std::endl;
+    assert(output == R"({"m_int":1,"m_float":0.5,"m_double":0.25,"m_char":"\"","m_cstr":"tab\there",)"
+                     R"("m_str":"line\nbreak \"quoted\" back\\slash \u0001 and a long clean run of text","m_bool":true})");
+
+    // exact for everything but floating point, which counts its longest form
+    assert(tinyrefl::json_size(escaped) >= output.size());
+    output.clear();
+    tinyrefl::reflection_to_json(obj.m_maps, output);
+    assert(tinyrefl::json_size(obj.m_maps) == output.size());
+    std::cout << "json_size: " << tinyrefl::json_size(obj.m_maps) << " == " << output.size() << std::endl;
+
+    // json_writer as an explicit sink, several documents into one buffer
+    std::string batch;
+    {
+        tinyrefl::json_writer writer(batch);
+        tinyrefl::reflection_to_json(obj.m_maps, writer);
+        writer.push_back('\n');
+        tinyrefl::reflection_to_json(escaped, writer);
+    }
+    std::string single;
+    tinyrefl::reflection_to_json(escaped, single);
+    assert(batch == output + "\n" + single);
+
+    std::cout << "--- Field mask ---" << std::endl;
+    tinyrefl::field_mask<BasicTypes> fields{"m_str", "m_int", "m_bool"};
+    std::string selected;
+    tinyrefl::reflection_to_json(escaped, selected, fields);
+    std::cout << selected << std::endl;
+    assert(selected == R"({"m_int":1,"m_str":"line\nbreak \"quoted\" back\\slash \u0001 and a long clean run of text","m_bool":true})");
+
+    // the cached plan of the same mask, then the full and the empty selection
+    selected.clear();
+    tinyrefl::reflection_to_json(escaped, selected, fields);
+    tinyrefl::reflection_to_json(escaped, selected, tinyrefl::field_mask<BasicTypes>{"m_double"});
+    assert(selected == R"({"m_int":1,"m_str":"line\nbreak \"quoted\" back\\slash \u0001 and a long clean run of text","m_bool":true})"
+                       R"({"m_double":0.25})");
+    selected.clear();
+    tinyrefl::reflection_to_json(escaped, selected, tinyrefl::field_mask<BasicTypes>::all());
+    assert(selected == single);
+    selected.clear();
+    tinyrefl::reflection_to_json(escaped, selected, tinyrefl::field_mask<BasicTypes>{});
+    assert(selected == "{}");
+
+    // a long string is prepared at its escaped size, not six times its length
+    BasicTypes large{};
+    large.m_str.assign(8 << 20, 'x');
+    large.m_str[100] = '"';
+    std::string large_output;
+    tinyrefl::reflection_to_json(large, large_output);
+    assert(large_output.find(R"("m_str":"xx)") != std::string::npos && large_output.find(R"(x\"x)") != std::string::npos);
+    assert(large_output.capacity() <= 2 * large_output.size());
+
     return 0;
 }
@@ -1,460 +1,1218 @@
 #pragma once
-#include "utils/reflection_get_tuple.hpp"
+#include "utils/reflection_key_index.hpp"
+#include "utils/reflection_json_scan.hpp"
+#include "utils/reflection_json_number.hpp"
+#include "utils/reflection_field_mask.hpp"
+#include "utils/reflection_generator.hpp"
+#include "utils/reflection_parallel.hpp"
+
+#include <charconv>
+#include <cstdlib>
+#include <cmath>
+#include <span>
+#include <memory>
+#include <cstring>
+#include <bitset>
+#include <string_view>
+#include <vector>
 
 #include "thirdparty/rapidjson/reader.h"
 #include "thirdparty/rapidjson/error/en.h"
 
+namespace tinyrefl
+{
+    // parse options, combined as a bit mask
+    enum ParseFlag : unsigned
+    {
+        kParseNoFlags = 0,
+        kParseOverwriteFlag = 1 << 0,  // replace sequence contents in place instead of appending, reusing capacity
+        kParseInsituFlag = 1 << 1,     // decode strings inside a mutable input buffer, string_view/char* members point into it
+    };
+} // end tinyrefl namespace
+
 namespace tinyrefl::detail
 {
-    // declear reader
-    template <typename T>
-    requires is_custom_type_v<T>
-    struct ReaderHandler;
+    // Bounded input stream over a (ptr, length) slice, no NUL terminator needed.
+    // Peek() returns '\0' at the end like rapidjson's MemoryStream, which the reader
+    // already treats as end of input.
+    class BufferStream
+    {
+    public:
+        typedef char Ch;
 
-    template <typename T>
-    requires is_sequence_container_v<T>
-    struct SequenceReaderHandler;
+        BufferStream(const char *str, ::std::size_t length) : _begin(str), _cur(str), _end(str + length) {}
+
+        Ch Peek() const { return _cur != _end ? *_cur : '\0'; }
+        Ch Take() { return _cur != _end ? *_cur++ : '\0'; }
+        ::std::size_t Tell() const { return static_cast<::std::size_t>(_cur - _begin); }
 
-	template <typename T, typename IndexSeq>
-	struct ReaderHandlerImp;
+        // raw access for the contiguous fast paths
+        const char *position() const { return _cur; }
+        const char *last() const { return _end; }
+        void seek(const char *position) { _cur = position; }
 
+    private:
+        const char *_begin;
+        const char *_cur;
+        const char *_end;
+    };
+
+    // members that can point into the input buffer of an in situ parse
     template <typename T>
-    class SequenceReaderHandleImp;
+    inline constexpr bool is_insitu_string_v = ::std::is_same_v<remove_cvref_t<T>, ::std::string_view> ||
+                                               ::std::is_same_v<remove_cvref_t<T>, const char *>;
 
-    class DispatchHandler;
+    // Mutable bounded input stream for kParseInsituFlag, like rapidjson's InsituStringStream.
+    // Decoded strings are written back over their own source bytes: the write position
+    // never passes the read position, since a decoded string is never longer than its source.
+    class InsituStream
+    {
+    public:
+        typedef char Ch;
 
-    // Can convert assignment
-    template <typename Target, typename From>
-    constexpr bool is_json_compatible_v = ::std::is_assignable_v<Target &, From>;
+        InsituStream(char *str, ::std::size_t length) : _begin(str), _cur(str), _end(str + length), _dst(str) {}
 
-    template <typename T, typename IndexSeq>
-    struct ReaderHandlerHelper;
+        Ch Peek() const { return _cur != _end ? *_cur : '\0'; }
+        Ch Take() { return _cur != _end ? *_cur++ : '\0'; }
+        ::std::size_t Tell() const { return static_cast<::std::size_t>(_cur - _begin); }
 
-	template <typename T, size_t... Is>
-	struct ReaderHandlerHelper<T, ::std::index_sequence<Is...>>
-	{
-		using Type = ReaderHandlerImp<T, ::std::index_sequence<Is...>>;
-	};
+        // raw access for the contiguous fast paths
+        const char *position() const { return _cur; }
+        const char *last() const { return _end; }
+        void seek(const char *position) { _cur = const_cast<char *>(position); }
 
-    template <typename T>
-    using ReaderHandleImpType = ReaderHandlerHelper<
-        remove_cvref_t<T>,
-        serializable_indices_t<remove_cvref_t<T>>>::Type;
+        // write position starts at the current read position
+        char *PutBegin() { return _dst = _cur; }
+        void Put(Ch c) { *_dst++ = c; }
+        // NUL terminate the decoded bytes, returns their length
+        ::std::size_t PutEnd(char *begin)
+        {
+            *_dst = '\0';
+            return static_cast<::std::size_t>(_dst - begin);
+        }
 
-    template <typename T>
-        requires is_custom_type_v<T>
-    struct ReaderHandler : public ReaderHandleImpType<T>
+    private:
+        char *_begin;
+        char *_cur;
+        char *_end;
+        char *_dst;
+    };
+
+    // stream over one contiguous buffer, values can be scanned through raw pointers
+    template <typename Stream>
+    concept ContiguousInputStream = requires(Stream &s, const char *p) {
+        { s.position() } -> ::std::same_as<const char *>;
+        { s.last() } -> ::std::same_as<const char *>;
+        s.seek(p);
+    };
+
+    // Recursive descent reader over a rapidjson input stream (Peek/Take/Tell).
+    // The nesting of T is known at compile time, so every nested struct or
+    // sequence is a statically typed read_value<U> frame on the call stack:
+    // no handler objects, no heap, no vtable.
+    template <typename Stream, unsigned Flags = kParseNoFlags>
+    class JsonReader;
+
+    // member reader table, position i reads the i-th index in serializable_indices_t<T>
+    template <typename Reader, typename T, ::std::size_t I>
+    inline bool read_member(Reader &reader, T &object)
     {
-        using U = remove_cvref_t<T>;
-        using Base = ReaderHandleImpType<U>;
+        return reader.read_value(struct_member_reference<I>(object));
+    }
 
-        using MapType = typename Base::MapType;
+    template <typename Reader, typename T, ::std::size_t... Is>
+    consteval auto make_member_reader_table(::std::index_sequence<Is...>)
+    {
+        using ReadFunction = bool (*)(Reader &, T &);
+        return ::std::array<ReadFunction, sizeof...(Is)>{&read_member<Reader, T, Is>...};
+    }
 
-        ReaderHandler(const MapType &map_value, U &value)
-            : Base(map_value, value) {}
-    };
+    template <typename Reader, typename T>
+    inline constexpr auto member_reader_table_v = make_member_reader_table<Reader, T>(serializable_indices_t<T>{});
 
+    // a default constructed T, what a fresh parse starts from
     template <typename T>
-        requires is_sequence_container_v<T>
-    struct SequenceReaderHandler : public SequenceReaderHandleImp<T>
+    inline const T &fresh_value()
     {
-        SequenceReaderHandler(T &value) : SequenceReaderHandleImp<T>(value) {}
-    };
+        static const T fresh{};
+        return fresh;
+    }
 
-    struct IHandler
+    // bring value back to fresh, containers and strings that are empty when fresh are
+    // cleared so that they keep their capacity
+    template <typename T>
+    inline void reset_to(T &value, const T &fresh)
     {
-        virtual bool Null() = 0;
-        virtual bool Bool(bool) = 0;
-        virtual bool Int(int) = 0;
-        virtual bool Uint(unsigned) = 0;
-        virtual bool Int64(int64_t) = 0;
-        virtual bool Uint64(uint64_t) = 0;
-        virtual bool Double(double) = 0;
-        virtual bool RawNumber(const char *str, ::rapidjson::SizeType length, bool copy) = 0;
-        virtual bool String(const char *, ::rapidjson::SizeType, bool) = 0;
-        virtual bool StartObject() = 0;
-        virtual bool Key(const char *, ::rapidjson::SizeType, bool) = 0;
-        virtual bool EndObject(::rapidjson::SizeType) = 0;
-        virtual bool StartArray() = 0;
-        virtual bool EndArray(::rapidjson::SizeType) = 0;
-
-        virtual void set_dispatcher(DispatchHandler *dispatcher) = 0;
-        virtual ~IHandler() = default;
-    };
+        if constexpr (::std::is_array_v<T>) {
+            for (::std::size_t i = 0; i < ::std::extent_v<T>; ++i) {
+                reset_to(value[i], fresh[i]);
+            }
+        }
+        else if constexpr (is_custom_type_v<T> && ::std::is_aggregate_v<T>) {
+            [&]<::std::size_t... Is>(::std::index_sequence<Is...>) {
+                (reset_to(struct_member_reference<Is>(value), struct_member_reference<Is>(fresh)), ...);
+            }(::std::make_index_sequence<members_count_v<T>>{});
+        }
+        else if constexpr (requires { value.clear(); fresh.empty(); }) {
+            if (fresh.empty()) {
+                value.clear();
+            }
+            else {
+                value = fresh;
+            }
+        }
+        else {
+            value = fresh;
+        }
+    }
+
+    // member reset table, position i resets the i-th index in serializable_indices_t<T>
+    template <typename T, ::std::size_t I>
+    inline void reset_member(T &object)
+    {
+        reset_to(struct_member_reference<I>(object), struct_member_reference<I>(fresh_value<T>()));
+    }
+
+    template <typename T, ::std::size_t... Is>
+    consteval auto make_member_reset_table(::std::index_sequence<Is...>)
+    {
+        using ResetFunction = void (*)(T &);
+        return ::std::array<ResetFunction, sizeof...(Is)>{&reset_member<T, Is>...};
+    }
 
-    class DispatchHandler : public ::rapidjson::BaseReaderHandler<::rapidjson::UTF8<>, DispatchHandler>
+    template <typename T>
+    inline constexpr auto member_reset_table_v = make_member_reset_table<T>(serializable_indices_t<T>{});
+
+    template <typename Stream, unsigned Flags>
+    class JsonReader
     {
     public:
-        template <AggregateType T>
-        DispatchHandler(T &value)
+        // parse a whole document into value, scratch buffers are kept between calls
+        template <typename T>
+        bool parse(Stream &is, T &value)
         {
-            static auto member_offset_map = struct_member_offset_map<T>();
-            this->push_handler(member_offset_map, value);
+            return parse_root(is, value, nullptr);
         }
-        ~DispatchHandler()
+
+        // parse a whole document, only the members of the root object selected by mask are read,
+        // the others are skipped with the scanner: no assignment, no allocation
+        template <typename T>
+        bool parse(Stream &is, T &value, const field_mask<remove_cvref_t<T>> &mask)
         {
-            while (!_stack.empty())
-            {
-                delete _stack.back();
-                _stack.pop_back();
+            return parse_root(is, value, &mask);
+        }
+
+    private:
+        template <typename T, typename Mask>
+        bool parse_root(Stream &is, T &value, Mask mask)
+        {
+            _is = &is;
+            _code = ::rapidjson::kParseErrorNone;
+            _offset = 0;
+            _reusing = false;
+
+            skip_whitespace();
+            if (_is->Peek() == '\0') {
+                return set_error(::rapidjson::kParseErrorDocumentEmpty);
+            }
+            bool ok = false;
+            if constexpr (::std::is_null_pointer_v<Mask>) {
+                ok = read_value(value);
             }
+            else {
+                ok = _is->Peek() == '{' ? read_object(value, mask) : skip_value();
+            }
+            return ok && read_document_end();
         }
 
     public:
-        template <typename T>
-            requires is_custom_type_v<T>
-        void push_handler(const typename ReaderHandler<T>::MapType &map, T &value)
+        // Element-wise reading of a root array, for documents too large to hold at once:
+        // begin_array consumes the '[', then read_element reads one element into value and
+        // end_element the separator after it. end: the array was empty or has just been closed,
+        // and the document ended there. read: false for a skipped element of a mismatched json type
+        bool begin_array(Stream &is, bool &end)
         {
-            auto *h = new ReaderHandler<T>(map, value);
-            h->set_dispatcher(this);
-            _stack.emplace_back(h);
+            _is = &is;
+            _code = ::rapidjson::kParseErrorNone;
+            _offset = 0;
+            _reusing = false;
+
+            skip_whitespace();
+            if (_is->Peek() == '\0') {
+                return set_error(::rapidjson::kParseErrorDocumentEmpty);
+            }
+            if (_is->Peek() != '[') {
+                return set_error(::rapidjson::kParseErrorValueInvalid);
+            }
+            _is->Take();
+            skip_whitespace();
+            end = _is->Peek() == ']';
+            if (end) {
+                _is->Take();
+                return read_document_end();
+            }
+            return true;
         }
 
         template <typename T>
-            requires is_sequence_container_v<T>
-        void push_handler(T &value)
+        bool read_element(T &value, bool &read)
         {
-            auto *h = new SequenceReaderHandler<T>(value);
-            h->set_dispatcher(this);
-            _stack.emplace_back(h);
+            read = accepts<remove_cvref_t<T>>(_is->Peek());
+            if (!read) {
+                return skip_value();
+            }
+            // overwrite: value is the previous element, reused
+            return overwrite ? read_reused(value, true) : read_value(value);
         }
 
-        void pop_handler()
+        bool end_element(bool &end)
         {
-            // delete _stack.back();
-            _stack.pop_back();
+            if (!read_element_separator(end)) {
+                return false;
+            }
+            return !end || read_document_end();
         }
 
     public:
-        bool Bool(bool b) { return top()->Bool(b); }
-        bool Int(int i) { return top()->Int(i); }
-        bool Key(const char *s, ::rapidjson::SizeType l, bool c) { return top()->Key(s, l, c); }
-        bool Null() { return top()->Null(); }
-        bool Uint(unsigned u) { return top()->Uint(u); }
-
-        bool Int64(int64_t i) { return top()->Int64(i); }
-
-        bool Uint64(uint64_t u) { return top()->Uint64(u); }
-        bool Double(double d) { return top()->Double(d); }
-        bool RawNumber(const char *str, ::rapidjson::SizeType length, bool copy) { return top()->RawNumber(str, length, copy); }
-        bool String(const char *str, ::rapidjson::SizeType length, bool copy) { return top()->String(str, length, copy); }
-		bool StartArray()
-		{
-			bool result = top()->StartArray();
-			_array_depth.push_back(result);
-			return true;
-		}
-		bool EndArray(::rapidjson::SizeType elementCount)
-		{
-			if (_array_depth.empty()) {
-				return true;
-			}
-
-			bool should_pop = _array_depth.back();
-			_array_depth.pop_back();
-
-			if (_stack.empty()) {
-				return true;
-			}
-
-			bool result = top()->EndArray(elementCount);
-			if (should_pop) {
-				pop_handler();
-			}
-			return result;
-		}
-		bool StartObject()
-		{
-			if (_is_first_member) {
-				_is_first_member = false;
-				_nested_depth.push_back(true);
-				return true;
-			}
-			bool result = top()->StartObject();
-			_nested_depth.push_back(result);
-			return true;
-		}
-
-		bool EndObject(::rapidjson::SizeType m)
-		{
-			if (_nested_depth.empty())
-				return true;
-
-			bool should_pop = _nested_depth.back();
-			_nested_depth.pop_back();
-
-			if (_stack.empty())
-				return true;
-
-			bool result = top()->EndObject(m);
-			if (should_pop) {
-				pop_handler();
-			}
-			return result;
-		}
-
-    private:
-        IHandler *top() const { return _stack.back(); }
-
-    private:
-        ::std::vector<IHandler *> _stack;
-		::std::vector<bool> _nested_depth;
-		::std::vector<bool> _array_depth;
+        ::rapidjson::ParseErrorCode code() const { return _code; }
+        ::std::size_t offset() const { return _offset; }
 
-        bool _is_first_member = true;
-    };
-
-    // ::rapidjson::BaseReaderHandler<::rapidjson::UTF8<>, ReaderHandlerImp<T, Is...>>
-    template <typename T, size_t... Is>
-	struct ReaderHandlerImp<T, ::std::index_sequence<Is...>> : public IHandler
-    {
-        using Tuple = decltype(struct_members_to_tuple<T>());
-        using ValueType = decltype(get_variant_type<T, Tuple, Is...>());
-        using MapType = ::std::unordered_map<::std::string, ValueType>;
-
-    public:
-		ReaderHandlerImp(const MapType& map_value, T& value)
-			: _struct_member_offset_map(map_value)
-			, _iterator(_struct_member_offset_map.end())
-			, _value(value) {}
+        // keys matched by the declaration order prediction / looked up in the key index,
+        // counted over the lifetime of the reader
+        ::std::size_t key_hits() const { return _key_hits; }
+        ::std::size_t key_misses() const { return _key_misses; }
 
     public:
-        bool Null()
+        // read one value into value, values of a mismatched json type are skipped
+        template <typename T>
+        bool read_value(T &value)
         {
-            if (_iterator != _struct_member_offset_map.end())
-            {
-                // TODO
+            using U = remove_cvref_t<T>;
+            const char c = _is->Peek();
+            if (!accepts<U>(c)) {
+                return skip_value();
+            }
+
+            if constexpr (is_custom_type_v<U>) {
+                return read_object(value);
+            }
+            else if constexpr (is_sequence_container_v<U>) {
+                return read_sequence(value);
+            }
+            else if constexpr (is_associative_container_v<U>) {
+                return read_map(value);
+            }
+            else if constexpr (is_string_v<U>) {
+                if constexpr (insitu) {
+                    const char *str = nullptr;
+                    ::std::size_t length = 0;
+                    if (!read_string_insitu(str, length)) {
+                        return false;
+                    }
+                    value.assign(str, length);
+                    return true;
+                }
+                else {
+                    value.clear();
+                    return read_string([&](char ch) { value.push_back(ch); });
+                }
+            }
+            else if constexpr (is_insitu_string_v<U> && insitu) {
+                if (c == 'n') {
+                    if (!read_literal("null")) {
+                        return false;
+                    }
+                    value = U{};
+                    return true;
+                }
+                const char *str = nullptr;
+                ::std::size_t length = 0;
+                if (!read_string_insitu(str, length)) {
+                    return false;
+                }
+                if constexpr (is_string_view_v<U>) {
+                    value = ::std::string_view(str, length);
+                }
+                else {
+                    value = str;
+                }
+                return true;
+            }
+            else if constexpr (is_char_v<U>) {
+                if (c == '"') {
+                    bool first = true;
+                    return read_string([&](char ch) {
+                        if (first) {
+                            value = static_cast<U>(ch);
+                            first = false;
+                        }
+                    });
+                }
+                return read_number_to(value);
+            }
+            else if constexpr (is_bool_v<U>) {
+                if (!read_literal(c == 't' ? "true" : "false")) {
+                    return false;
+                }
+                value = (c == 't');
+                return true;
+            }
+            else if constexpr (is_int_v<U> || is_int64_v<U> || is_floating_v<U>) {
+                return read_number_to(value);
+            }
+            else {
+                return skip_value();
             }
-            return true;
         }
 
-        bool Bool(bool b) override
+        // skip one value of any json type, it is validated but not decoded
+        bool skip_value()
         {
-            return assign_if_match<bool>([&](auto &member)
-                                         { member = b; });
+            if constexpr (ContiguousInputStream<Stream>) {
+                // grammar check straight over the buffer, a malformed value is walked
+                // again token by token for the error code and offset
+                const char *end = scan_json_value(_is->position(), _is->last());
+                if (end != nullptr) {
+                    _is->seek(end);
+                    return true;
+                }
+            }
+            return walk_value();
         }
 
-        bool Int(int i) override
+    private:
+        // skip_value token by token through the input stream
+        bool walk_value()
         {
-            return assign_if_match<int>([&](auto &member)
-                                        { member = i; });
+            switch (_is->Peek()) {
+            case '{': {
+                _is->Take();
+                skip_whitespace();
+                if (_is->Peek() == '}') {
+                    _is->Take();
+                    return true;
+                }
+                for (;;) {
+                    if (_is->Peek() != '"') {
+                        return set_error(::rapidjson::kParseErrorObjectMissName);
+                    }
+                    if (!read_string([](char) {}) || !read_name_separator() || !walk_value()) {
+                        return false;
+                    }
+                    bool end = false;
+                    if (!read_member_separator(end)) {
+                        return false;
+                    }
+                    if (end) {
+                        return true;
+                    }
+                }
+            }
+            case '[': {
+                _is->Take();
+                skip_whitespace();
+                if (_is->Peek() == ']') {
+                    _is->Take();
+                    return true;
+                }
+                for (;;) {
+                    if (!walk_value()) {
+                        return false;
+                    }
+                    bool end = false;
+                    if (!read_element_separator(end)) {
+                        return false;
+                    }
+                    if (end) {
+                        return true;
+                    }
+                }
+            }
+            case '"':
+                return read_string([](char) {});
+            case 't':
+                return read_literal("true");
+            case 'f':
+                return read_literal("false");
+            case 'n':
+                return read_literal("null");
+            default: {
+                Number number;
+                return read_number(number);
+            }
+            }
         }
 
-        bool Uint(unsigned u) override
+        static constexpr bool overwrite = (Flags & kParseOverwriteFlag) != 0;
+        static constexpr bool insitu = (Flags & kParseInsituFlag) != 0;
+
+        template <typename T>
+        static bool accepts(char c)
         {
-            return assign_if_match<unsigned>([&](auto &member)
-                                             { member = u; });
+            if constexpr (is_custom_type_v<T>) {
+                return c == '{';
+            }
+            else if constexpr (is_sequence_container_v<T>) {
+                return c == '[';
+            }
+            else if constexpr (is_associative_container_v<T>) {
+                // json object keys are strings
+                return is_string_v<typename T::key_type> && c == '{';
+            }
+            else if constexpr (is_string_v<T>) {
+                return c == '"';
+            }
+            else if constexpr (is_insitu_string_v<T>) {
+                // views need a buffer that outlives the parse, left untouched unless in situ
+                return insitu && (c == '"' || c == 'n');
+            }
+            else if constexpr (is_char_v<T>) {
+                return c == '"' || c == '-' || (c >= '0' && c <= '9');
+            }
+            else if constexpr (is_bool_v<T>) {
+                return c == 't' || c == 'f';
+            }
+            else if constexpr (is_int_v<T> || is_int64_v<T> || is_floating_v<T>) {
+                return c == '-' || (c >= '0' && c <= '9');
+            }
+            else {
+                return false;
+            }
         }
 
-        bool Int64(int64_t i) override
+        // mask: nullptr or the field_mask of the members to read
+        template <typename T, typename Mask = ::std::nullptr_t>
+        bool read_object(T &value, Mask mask = nullptr)
         {
-            return assign_if_match<int64_t>([&](auto &member)
-                                            { member = i; });
+            using U = remove_cvref_t<T>;
+            constexpr auto &key_index = member_key_index_v<U>;
+            constexpr auto &reader_table = member_reader_table_v<JsonReader, U>;
+            // overwrite into a reused object: members the message leaves out are reset
+            [[maybe_unused]] ::std::bitset<reader_table.size()> seen;
+
+            _is->Take();
+            skip_whitespace();
+            if (_is->Peek() == '}') {
+                _is->Take();
+                if constexpr (overwrite) {
+                    reset_unseen(value, seen);
+                }
+                return true;
+            }
+            ::std::size_t expected = 0;
+            // selected members not read yet, a repeated key counts once
+            ::std::size_t remaining = 0;
+            [[maybe_unused]] ::std::conditional_t<::std::is_null_pointer_v<Mask>, bool, field_mask<U>> pending{};
+            if constexpr (!::std::is_null_pointer_v<Mask>) {
+                remaining = mask->count();
+                pending = *mask;
+            }
+            for (;;) {
+                if (_is->Peek() != '"') {
+                    return set_error(::rapidjson::kParseErrorObjectMissName);
+                }
+                const char *key = nullptr;
+                ::std::size_t key_length = 0;
+                if (!read_key(key, key_length)) {
+                    return false;
+                }
+
+                // keys written by reflection_to_json arrive in declaration order:
+                // try the member after the previous one before hashing
+                ::std::size_t pos = key_index.keys.size();
+                if (expected < key_index.keys.size() && key_index.keys[expected].size() == key_length &&
+                    ::std::memcmp(key_index.keys[expected].data(), key, key_length) == 0) {
+                    pos = expected;
+                    ++_key_hits;
+                }
+                else {
+                    pos = key_index.find(key, key_length);
+                    ++_key_misses;
+                }
+                if (pos < key_index.keys.size()) {
+                    // an unknown key keeps the prediction for the next one
+                    expected = pos + 1;
+                }
+                bool selected = pos < reader_table.size();
+                if constexpr (!::std::is_null_pointer_v<Mask>) {
+                    selected = selected && mask->test(pos);
+                }
+                if (selected) {
+                    if constexpr (overwrite) {
+                        seen.set(pos);
+                    }
+                    if (!reader_table[pos](*this, value)) {
+                        return false;
+                    }
+                    if constexpr (!::std::is_null_pointer_v<Mask> && ContiguousInputStream<Stream>) {
+                        // every selected member is read, jump over the rest of the object
+                        if (pending.test(pos)) {
+                            pending.reset(pos);
+                            if (--remaining == 0) {
+                                return skip_object_rest();
+                            }
+                        }
+                    }
+                }
+                else if (!skip_value()) {
+                    return false;
+                }
+
+                bool end = false;
+                if (!read_member_separator(end)) {
+                    return false;
+                }
+                if (end) {
+                    if constexpr (overwrite) {
+                        reset_unseen(value, seen);
+                    }
+                    return true;
+                }
+            }
         }
 
-        bool Uint64(uint64_t u) override
+        template <typename T, typename Seen>
+        void reset_unseen(T &value, const Seen &seen)
         {
-            return assign_if_match<uint64_t>([&](auto &member)
-                                             { member = u; });
+            if (!_reusing) {
+                return;
+            }
+            constexpr auto &reset_table = member_reset_table_v<remove_cvref_t<T>>;
+            for (::std::size_t i = 0; i < reset_table.size(); ++i) {
+                if (!seen.test(i)) {
+                    reset_table[i](value);
+                }
+            }
         }
-        bool Double(double d) override
+
+        // read into an existing element (reused) or a new one, nested objects of a reused
+        // element are reused too
+        template <typename T>
+        bool read_reused(T &value, bool reused)
         {
-            return assign_if_match<double>([&](auto &member)
-                                           { member = d; });
+            const bool reusing = ::std::exchange(_reusing, reused);
+            const bool ok = read_value(value);
+            _reusing = reusing;
+            return ok;
         }
-        bool RawNumber(const char *str, ::rapidjson::SizeType length, bool copy) override
+
+        template <typename T>
+        bool read_sequence(T &value)
         {
-            return assign_if_match<const char *>([&](auto &member)
-                                                 { member = str; });
+            using ElementType = sequence_element_type_t<remove_cvref_t<T>>;
+
+            _is->Take();
+            skip_whitespace();
+            if (_is->Peek() == ']') {
+                _is->Take();
+                if constexpr (overwrite) {
+                    value.clear();
+                }
+                return true;
+            }
+
+            // overwrite: existing elements are read in place, the rest is appended or trimmed
+            auto it = value.begin();
+            if constexpr (is_number_vector_v<remove_cvref_t<T>> && ContiguousInputStream<Stream>) {
+                bool end = false;
+                if (!read_number_run(value, end)) {
+                    return false;
+                }
+                if (end) {
+                    return true;
+                }
+                it = value.end();
+            }
+            for (;;) {
+                // mismatched elements are skipped, not default appended
+                if (accepts<ElementType>(_is->Peek())) {
+                    if constexpr (overwrite) {
+                        if (it != value.end()) {
+                            if (!read_reused(*it, true)) {
+                                return false;
+                            }
+                            ++it;
+                        }
+                        else {
+                            if (!read_reused(value.emplace_back(), false)) {
+                                return false;
+                            }
+                            it = value.end();
+                        }
+                    }
+                    else if (!read_value(value.emplace_back())) {
+                        return false;
+                    }
+                }
+                else if (!skip_value()) {
+                    return false;
+                }
+
+                bool end = false;
+                if (!read_element_separator(end)) {
+                    return false;
+                }
+                if (end) {
+                    if constexpr (overwrite) {
+                        value.erase(it, value.end());
+                    }
+                    return true;
+                }
+            }
         }
-        bool String(const char *str, ::rapidjson::SizeType length, bool copy) override
+
+        // map<string, V> / unordered_map<string, V>, duplicate keys read into the same value
+        template <typename T>
+        bool read_map(T &value)
         {
-            return assign_if_match<const char *>([&](auto &member)
-                                                 { member = str; });
+            using MapType = remove_cvref_t<T>;
+            using KeyType = typename MapType::key_type;
+            using MappedType = typename MapType::mapped_type;
+
+            if constexpr (overwrite) {
+                value.clear();
+            }
+
+            _is->Take();
+            skip_whitespace();
+            if (_is->Peek() == '}') {
+                _is->Take();
+                return true;
+            }
+            if constexpr (ContiguousInputStream<Stream> && requires { value.reserve(::std::size_t{}); }) {
+                // one rehash instead of a growth per doubling, the count is only a hint
+                reserve_more(value, count_json_elements(_is->position(), _is->last()));
+            }
+            for (;;) {
+                if (_is->Peek() != '"') {
+                    return set_error(::rapidjson::kParseErrorObjectMissName);
+                }
+                const char *key = nullptr;
+                ::std::size_t key_length = 0;
+                if (!read_key(key, key_length)) {
+                    return false;
+                }
+                if (accepts<MappedType>(_is->Peek())) {
+                    // a key already in the map is found without building a KeyType, a new one is
+                    // built once from the decoded bytes and moved into the new node. Overwrite
+                    // starts from an empty map, where only a repeated key could be found
+                    auto it = value.end();
+                    if constexpr (!overwrite) {
+                        it = find_key(value, key, key_length);
+                    }
+                    if (it == value.end()) {
+                        it = value.try_emplace(KeyType(key, key_length)).first;
+                    }
+                    if (!read_value(it->second)) {
+                        return false;
+                    }
+                }
+                else if (!skip_value()) {
+                    return false;
+                }
+
+                bool end = false;
+                if (!read_member_separator(end)) {
+                    return false;
+                }
+                if (end) {
+                    return true;
+                }
+            }
         }
-        bool StartObject() override
+
+        // transparent lookup when the map has it, else through _key: no allocation once warm
+        template <typename T>
+        auto find_key(T &value, const char *key, ::std::size_t key_length)
         {
-            bool found = (_iterator != _struct_member_offset_map.end());
-            if (found)
-            {
-                auto offset = _iterator->second;
-                bool pushed = false;
-                ::std::visit([&](auto arg) {
-                    using Value_Type = typename decltype(arg)::type;
-                    if constexpr (is_custom_type_v<Value_Type>) {
-                        static auto member_offset_map = struct_member_offset_map<Value_Type>();
-                        Value_Type& member_value = *reinterpret_cast<Value_Type*>(
-                            reinterpret_cast<char*>(static_cast<T*>(&_value)) + arg.value
-                        );
-                        _dispatch_handler->push_handler<Value_Type>(member_offset_map, member_value);
-                        pushed = true;
-                } }, offset);
-                return pushed;
+            using KeyType = typename remove_cvref_t<T>::key_type;
+            if constexpr (requires { value.find(::std::string_view()); }) {
+                return value.find(::std::string_view(key, key_length));
+            }
+            else if constexpr (::std::is_same_v<KeyType, ::std::string>) {
+                if (key != _key.data()) {
+                    _key.assign(key, key_length);
+                }
+                return value.find(_key);
+            }
+            else {
+                return value.find(KeyType(key, key_length));
             }
-            return false;
         }
-        bool Key(const char *str, ::rapidjson::SizeType length, bool copy) override
-        {
-			_iterator = _struct_member_offset_map.find(::std::string(str, length));
-			bool found = (_iterator != _struct_member_offset_map.end());
-			return true;
-        }
-        bool EndObject(::rapidjson::SizeType memberCount) override { return true; }
-		bool StartArray() override
-		{
-			bool found = (_iterator != _struct_member_offset_map.end());
-			if (found)
-			{
-				auto offset = _iterator->second;
-				bool pushed = false;
-				::std::visit([&](auto arg) {
-					using Value_Type = typename decltype(arg)::type;
-					if constexpr (is_sequence_container_v<Value_Type>) {
-						Value_Type& member_value = *reinterpret_cast<Value_Type*>(
-							reinterpret_cast<char*>(static_cast<T*>(&_value)) + arg.value
-							);
-						_dispatch_handler->push_handler<Value_Type>(member_value);
-						pushed = true;
-				} }, offset);
-				return pushed;
-			}
-			return false;
-		}
-        bool EndArray(::rapidjson::SizeType elementCount) override { return true; }
 
-    private:
-        template <typename TargetType, typename F>
-        bool assign_if_match(F &&assign_func)
+        // an object key and the ':' after it, key points into the buffer or at _key
+        bool read_key(const char *&key, ::std::size_t &key_length)
         {
-            if (_iterator != _struct_member_offset_map.end())
-            {
-                auto offset = _iterator->second;
-                ::std::visit([&](auto arg)
-                             {
-                    using Value_Type = typename decltype(arg)::type;
-                    if constexpr (is_json_compatible_v<remove_cvref_t<Value_Type>, TargetType>) {
-                        Value_Type& member_value = *reinterpret_cast<Value_Type*>(
-                            reinterpret_cast<char*>(static_cast<T*>(&_value)) + arg.value
-                        );
-                        auto member_ptr = (Value_Type *)((char *)(&_value) + arg.value);
-                        assign_func(*member_ptr);
-                    } }, offset);
+            if constexpr (insitu) {
+                if (!read_string_insitu(key, key_length)) {
+                    return false;
+                }
             }
-            return true;
+            else {
+                _key.clear();
+                if (!read_string([&](char ch) { _key.push_back(ch); })) {
+                    return false;
+                }
+                key = _key.data();
+                key_length = _key.size();
+            }
+            return read_name_separator();
         }
 
-    public:
-        void set_dispatcher(DispatchHandler *dispatcher) override { _dispatch_handler = dispatcher; }
+        // room for count more elements, never below doubling so that repeated appends
+        // into the same container stay amortized
+        template <typename T>
+        static void reserve_more(T &value, ::std::size_t count)
+        {
+            const ::std::size_t size = value.size();
+            if constexpr (requires { value.capacity(); }) {
+                if (value.capacity() - size >= count) {
+                    return;
+                }
+            }
+            else if (static_cast<float>(size + count) <= value.max_load_factor() * static_cast<float>(value.bucket_count())) {
+                return;
+            }
+            value.reserve(::std::max(size + count, 2 * size));
+        }
 
-    private:
-        const MapType &_struct_member_offset_map;
-        typename MapType::const_iterator _iterator;
-        T &_value;
-        DispatchHandler *_dispatch_handler = nullptr;
-    };
+        template <typename T>
+        static constexpr bool is_number_vector_v = is_template_instant_of<::std::vector, T>::value &&
+            (is_int_v<typename T::value_type> || is_int64_v<typename T::value_type> ||
+             is_floating_v<typename T::value_type>);
 
-    // SequenceReaderHandle
-    template <typename T>
-    class SequenceReaderHandleImp : public IHandler
-    {
-        using ElementType = sequence_element_type_t<remove_cvref_t<T>>;
+        // Inside a non-empty vector<number>: the elements are parsed straight from the buffer
+        // into storage reserved from the comma count. An element the kernel does not handle
+        // is left at the stream position for the general loop, end says ']' was consumed.
+        template <typename T>
+        bool read_number_run(T &value, bool &end)
+        {
+            using ElementType = typename T::value_type;
+            auto skip_space = [](const char *p, const char *last) {
+                while (p != last && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
+                    ++p;
+                }
+                return p;
+            };
+
+            const char *p = _is->position();
+            const char *last = _is->last();
+            if constexpr (overwrite) {
+                value.clear();
+            }
+            reserve_more(value, count_json_elements(p, last));
+            for (;;) {
+                ElementType number;
+                const char *next = parse_json_number_fast(p, last, number);
+                if (next == nullptr) {
+                    _is->seek(p);
+                    return true;
+                }
+                value.push_back(number);
+                p = skip_space(next, last);
+                if (p != last && *p == ',') {
+                    p = skip_space(p + 1, last);
+                    continue;
+                }
+                _is->seek(p);
+                if (p != last && *p == ']') {
+                    _is->Take();
+                    end = true;
+                    return true;
+                }
+                return set_error(::rapidjson::kParseErrorArrayMissCommaOrSquareBracket);
+            }
+        }
 
-    public:
-        SequenceReaderHandleImp(T &value) : _value(value) {}
+        // after a member of an object, skip the remaining members and the closing brace
+        bool skip_object_rest()
+        {
+            const char *end = scan_json_rest(_is->position(), _is->last(), '}');
+            if (end != nullptr) {
+                _is->seek(end);
+                return true;
+            }
+            for (;;) {
+                bool last = false;
+                if (!read_member_separator(last)) {
+                    return false;
+                }
+                if (last) {
+                    return true;
+                }
+                if (_is->Peek() != '"') {
+                    return set_error(::rapidjson::kParseErrorObjectMissName);
+                }
+                if (!read_string([](char) {}) || !read_name_separator() || !walk_value()) {
+                    return false;
+                }
+            }
+        }
 
-    public:
-        bool Null()
+        // nothing but whitespace after the root value
+        bool read_document_end()
         {
+            skip_whitespace();
+            if (_is->Peek() != '\0') {
+                return set_error(::rapidjson::kParseErrorDocumentRootNotSingular);
+            }
             return true;
         }
 
-        bool Bool(bool b) override
+        // ':' between a key and its value
+        bool read_name_separator()
         {
-            return assign_if_match<bool>([&](auto &member)
-                                         { member = b; });
+            skip_whitespace();
+            if (_is->Peek() != ':') {
+                return set_error(::rapidjson::kParseErrorObjectMissColon);
+            }
+            _is->Take();
+            skip_whitespace();
+            return true;
         }
 
-        bool Int(int i) override
+        // ',' or '}' after an object member
+        bool read_member_separator(bool &end)
         {
-            return assign_if_match<int>([&](auto &member)
-                                        { member = i; });
+            skip_whitespace();
+            const char c = _is->Peek();
+            if (c == ',') {
+                _is->Take();
+                skip_whitespace();
+                return true;
+            }
+            if (c == '}') {
+                _is->Take();
+                end = true;
+                return true;
+            }
+            return set_error(::rapidjson::kParseErrorObjectMissCommaOrCurlyBracket);
         }
 
-        bool Uint(unsigned u) override
+        // ',' or ']' after an array element
+        bool read_element_separator(bool &end)
         {
-            return assign_if_match<unsigned>([&](auto &member)
-                                             { member = u; });
+            skip_whitespace();
+            const char c = _is->Peek();
+            if (c == ',') {
+                _is->Take();
+                skip_whitespace();
+                return true;
+            }
+            if (c == ']') {
+                _is->Take();
+                end = true;
+                return true;
+            }
+            return set_error(::rapidjson::kParseErrorArrayMissCommaOrSquareBracket);
         }
 
-        bool Int64(int64_t i) override
+        bool read_literal(const char *literal)
         {
-            return assign_if_match<int64_t>([&](auto &member)
-                                            { member = i; });
+            for (; *literal; ++literal) {
+                if (_is->Peek() != *literal) {
+                    return set_error(::rapidjson::kParseErrorValueInvalid);
+                }
+                _is->Take();
+            }
+            return true;
         }
 
-        bool Uint64(uint64_t u) override
+        // decode a json string, every decoded byte goes to put
+        template <typename Put>
+        bool read_string(Put &&put)
         {
-            return assign_if_match<uint64_t>([&](auto &member)
-                                             { member = u; });
+            _is->Take();
+            for (;;) {
+                const char c = _is->Peek();
+                if (c == '"') {
+                    _is->Take();
+                    return true;
+                }
+                if (c == '\\') {
+                    _is->Take();
+                    if (!read_escape(put)) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    return set_error(c == '\0' ? ::rapidjson::kParseErrorStringMissQuotationMark
+                                               : ::rapidjson::kParseErrorStringInvalidEncoding);
+                }
+                put(_is->Take());
+            }
         }
-        bool Double(double d) override
+
+        // decode a json string over its own source bytes, str is NUL terminated
+        bool read_string_insitu(const char *&str, ::std::size_t &length)
         {
-            return assign_if_match<double>([&](auto &member)
-                                           { member = d; });
+            char *begin = _is->PutBegin();
+            if (!read_string([&](char ch) { _is->Put(ch); })) {
+                return false;
+            }
+            length = _is->PutEnd(begin);
+            str = begin;
+            return true;
         }
-        bool RawNumber(const char *str, ::rapidjson::SizeType length, bool copy) override
+
+        template <typename Put>
+        bool read_escape(Put &put)
         {
-            return assign_if_match<const char *>([&](auto &member)
-                                                 { member = str; });
+            const char c = _is->Take();
+            switch (c) {
+            case '"':  put('"');  return true;
+            case '\\': put('\\'); return true;
+            case '/':  put('/');  return true;
+            case 'b':  put('\b'); return true;
+            case 'f':  put('\f'); return true;
+            case 'n':  put('\n'); return true;
+            case 'r':  put('\r'); return true;
+            case 't':  put('\t'); return true;
+            case 'u': {
+                unsigned codepoint = 0;
+                if (!read_hex4(codepoint)) {
+                    return false;
+                }
+                if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+                    unsigned low = 0;
+                    if (_is->Peek() != '\\' || (_is->Take(), _is->Peek() != 'u')) {
+                        return set_error(::rapidjson::kParseErrorStringUnicodeSurrogateInvalid);
+                    }
+                    _is->Take();
+                    if (!read_hex4(low)) {
+                        return false;
+                    }
+                    if (low < 0xDC00 || low > 0xDFFF) {
+                        return set_error(::rapidjson::kParseErrorStringUnicodeSurrogateInvalid);
+                    }
+                    codepoint = (((codepoint - 0xD800) << 10) | (low - 0xDC00)) + 0x10000;
+                }
+                else if (codepoint >= 0xDC00 && codepoint <= 0xDFFF) {
+                    return set_error(::rapidjson::kParseErrorStringUnicodeSurrogateInvalid);
+                }
+                put_utf8(put, codepoint);
+                return true;
+            }
+            default:
+                return set_error(::rapidjson::kParseErrorStringEscapeInvalid);
+            }
         }
-        bool String(const char *str, ::rapidjson::SizeType length, bool copy) override
+
+        bool read_hex4(unsigned &codepoint)
         {
-            return assign_if_match<const char *>([&](auto &member)
-                                                 { member = str; });
+            for (int i = 0; i < 4; ++i) {
+                const char c = _is->Peek();
+                codepoint <<= 4;
+                if (c >= '0' && c <= '9') {
+                    codepoint += static_cast<unsigned>(c - '0');
+                }
+                else if (c >= 'A' && c <= 'F') {
+                    codepoint += static_cast<unsigned>(c - 'A' + 10);
+                }
+                else if (c >= 'a' && c <= 'f') {
+                    codepoint += static_cast<unsigned>(c - 'a' + 10);
+                }
+                else {
+                    return set_error(::rapidjson::kParseErrorStringUnicodeEscapeInvalidHex);
+                }
+                _is->Take();
+            }
+            return true;
         }
-        bool StartObject() override
+
+        template <typename Put>
+        static void put_utf8(Put &put, unsigned codepoint)
         {
-			if constexpr (is_custom_type_v<ElementType>)
-			{
-                static auto member_offset_map = struct_member_offset_map<ElementType>();
-				_dispatch_handler->push_handler<ElementType>(member_offset_map, _value.emplace_back());
-				return true;
-			}
-			return false;
+            if (codepoint <= 0x7F) {
+                put(static_cast<char>(codepoint));
+            }
+            else if (codepoint <= 0x7FF) {
+                put(static_cast<char>(0xC0 | ((codepoint >> 6) & 0xFF)));
+                put(static_cast<char>(0x80 | (codepoint & 0x3F)));
+            }
+            else if (codepoint <= 0xFFFF) {
+                put(static_cast<char>(0xE0 | ((codepoint >> 12) & 0xFF)));
+                put(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+                put(static_cast<char>(0x80 | (codepoint & 0x3F)));
+            }
+            else {
+                put(static_cast<char>(0xF0 | ((codepoint >> 18) & 0xFF)));
+                put(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+                put(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+                put(static_cast<char>(0x80 | (codepoint & 0x3F)));
+            }
         }
-        bool Key(const char *str, ::rapidjson::SizeType length, bool copy) override
+
+        struct Number
+        {
+            enum Kind { Int64, Uint64, Double } kind = Uint64;
+            union {
+                ::std::int64_t i;
+                ::std::uint64_t u;
+                double d;
+            };
+        };
+
+        // json number grammar, integers stay exact, everything else goes through from_chars
+        bool read_number(Number &number)
         {
+            char buffer[64];
+            ::std::size_t length = 0;
+            bool use_double = false;
+            auto take = [&] {
+                const char c = _is->Take();
+                if (length < sizeof(buffer)) {
+                    buffer[length] = c;
+                }
+                else {
+                    // very long literal, continue in the scratch buffer
+                    if (length == sizeof(buffer)) {
+                        _scratch.assign(buffer, length);
+                    }
+                    _scratch.push_back(c);
+                }
+                ++length;
+                return c;
+            };
+            auto is_digit = [&] { return _is->Peek() >= '0' && _is->Peek() <= '9'; };
+
+            const bool minus = _is->Peek() == '-';
+            if (minus) {
+                take();
+            }
+            ::std::uint64_t u = 0;
+            if (_is->Peek() == '0') {
+                take();
+            }
+            else if (is_digit()) {
+                while (is_digit()) {
+                    const unsigned digit = static_cast<unsigned>(take() - '0');
+                    if (u > (UINT64_MAX - digit) / 10) {
+                        use_double = true;
+                    }
+                    u = u * 10 + digit;
+                }
+            }
+            else {
+                return set_error(::rapidjson::kParseErrorValueInvalid);
+            }
+
+            if (_is->Peek() == '.') {
+                use_double = true;
+                take();
+                if (!is_digit()) {
+                    return set_error(::rapidjson::kParseErrorNumberMissFraction);
+                }
+                while (is_digit()) {
+                    take();
+                }
+            }
+            if (_is->Peek() == 'e' || _is->Peek() == 'E') {
+                use_double = true;
+                take();
+                if (_is->Peek() == '+' || _is->Peek() == '-') {
+                    take();
+                }
+                if (!is_digit()) {
+                    return set_error(::rapidjson::kParseErrorNumberMissExponent);
+                }
+                while (is_digit()) {
+                    take();
+                }
+            }
+
+            if (!use_double) {
+                if (!minus) {
+                    number.kind = Number::Uint64;
+                    number.u = u;
+                    return true;
+                }
+                if (u <= ::std::uint64_t(INT64_MAX) + 1) {
+                    number.kind = Number::Int64;
+                    number.i = static_cast<::std::int64_t>(0 - u);
+                    return true;
+                }
+            }
+
+            const char *first = buffer;
+            if (length >= sizeof(buffer)) {
+                first = _scratch.c_str();
+            }
+            number.kind = Number::Double;
+            auto [ptr, ec] = ::std::from_chars(first, first + length, number.d);
+            if (ec == ::std::errc::result_out_of_range) {
+                // from_chars reports both overflow and underflow, strtod tells them apart
+                _scratch.assign(first, length);
+                number.d = ::std::strtod(_scratch.c_str(), nullptr);
+                if (::std::isinf(number.d)) {
+                    return set_error(::rapidjson::kParseErrorNumberTooBig);
+                }
+            }
             return true;
         }
-        bool EndObject(::rapidjson::SizeType memberCount) override { return true; }
-        bool StartArray() override
+
+        // read a number into value, a number value can not hold is an error
+        template <typename T>
+        bool read_number_to(T &value)
         {
-			if constexpr (is_sequence_container_v<ElementType>)
-			{
-				_dispatch_handler->push_handler<ElementType>(_value.emplace_back());
-				return true;
-			}
-			return false;
+            Number number;
+            if (!read_number(number)) {
+                return false;
+            }
+            bool fits = true;
+            if constexpr (!is_floating_v<T>) {
+                if (number.kind == Number::Int64) {
+                    fits = json_integer_fits<T>(number.i < 0, number.i < 0 ? 0 - static_cast<::std::uint64_t>(number.i)
+                                                                           : static_cast<::std::uint64_t>(number.i));
+                }
+                else if (number.kind == Number::Uint64) {
+                    fits = json_integer_fits<T>(false, number.u);
+                }
+            }
+            if (number.kind == Number::Double) {
+                fits = json_double_fits<T>(number.d);
+            }
+            if (!fits) {
+                return set_error(::rapidjson::kParseErrorNumberTooBig);
+            }
+            switch (number.kind) {
+            case Number::Int64:  value = static_cast<T>(number.i); break;
+            case Number::Uint64: value = static_cast<T>(number.u); break;
+            case Number::Double: value = static_cast<T>(number.d); break;
+            }
+            return true;
         }
-        bool EndArray(::rapidjson::SizeType elementCount) override { return true; }
 
-    private:
-        template <typename TargetType, typename F>
-        bool assign_if_match(F &&assign_func)
+        void skip_whitespace()
         {
-            if constexpr (is_json_compatible_v<remove_cvref_t<ElementType>, TargetType>)
-            {
-                assign_func(_value.emplace_back());
+            for (;;) {
+                const char c = _is->Peek();
+                if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+                    return;
+                }
+                _is->Take();
             }
-            return true;
         }
 
-    public:
-        void set_dispatcher(DispatchHandler *dispatcher) override { _dispatch_handler = dispatcher; }
+        bool set_error(::rapidjson::ParseErrorCode code)
+        {
+            if (_code == ::rapidjson::kParseErrorNone) {
+                _code = code;
+                _offset = _is->Tell();
+            }
+            return false;
+        }
 
     private:
-        T &_value;
-        DispatchHandler *_dispatch_handler = nullptr;
+        Stream *_is = nullptr;
+        ::std::string _key;
+        ::std::string _scratch;
+        ::rapidjson::ParseErrorCode _code = ::rapidjson::kParseErrorNone;
+        ::std::size_t _offset = 0;
+        ::std::size_t _key_hits = 0;
+        ::std::size_t _key_misses = 0;
+        bool _reusing = false;
     };
 
 } // end tinyrefl::detail namespace
@@ -574,39 +1332,353 @@ namespace tinyrefl {
         return "Parse failed";
     }
 
-    // Deserialization Interface
-    template <detail::AggregateType T>
-    inline Status reflection_from_json(T &&object, const char *str) {
-        detail::DispatchHandler handler(object);
-        ::rapidjson::StringStream ss(str);
-        ::rapidjson::Reader reader;
-        auto result = reader.Parse<::rapidjson::kParseDefaultFlags>(ss, handler);
-
+    template <typename Reader>
+    inline Status make_status(const Reader &reader, bool ok, ::std::string_view source) {
         Status st{};
-        st.ok = !result.IsError();
+        st.ok = ok;
 
         if (!st.ok) {
-            const auto code = result.Code();
-            const auto off = result.Offset();
+            const auto code = reader.code();
+            const auto off = reader.offset();
 
             st.error.kind = map_kind(code);
             st.error.offset = off;
-            ::std::tie(st.error.line, st.error.column) = offset_to_linecol(str, off);
+            ::std::tie(st.error.line, st.error.column) = offset_to_linecol(source, off);
             st.error.message = translate_message(st.error.kind, code);
         }
         return st;
     }
 
+    // streams keep no text to count lines in, line and column stay 0
+    template <typename Reader>
+    inline Status make_status(const Reader &reader, bool ok) {
+        Status st = make_status(reader, ok, ::std::string_view());
+        st.error.line = 0;
+        st.error.column = 0;
+        return st;
+    }
+
+    // Deserialization Interface, bounded input: parses a (ptr, length) slice in place,
+    // e.g. straight out of a receive buffer or an mmapped file.
+    // kParseOverwriteFlag replaces the sequences of an existing object instead of appending to them
+    template <unsigned Flags = kParseNoFlags, detail::AggregateType T>
+    inline Status reflection_from_json(T &&object, ::std::string_view str) {
+        detail::BufferStream bs(str.data(), str.size());
+        detail::JsonReader<detail::BufferStream, Flags> reader;
+        const bool ok = reader.parse(bs, object);
+        return make_status(reader, ok, str);
+    }
+
+    // span<const char> or span<char>, e.g. a mutable receive buffer
+    template <unsigned Flags = kParseNoFlags, detail::AggregateType T, typename Char, ::std::size_t Extent>
+        requires ::std::is_same_v<::std::remove_const_t<Char>, char>
+    inline Status reflection_from_json(T &&object, ::std::span<Char, Extent> str) {
+        return reflection_from_json<Flags>(object, ::std::string_view(str.data(), str.size()));
+    }
+
+    // Deserialization Interface
+    template <unsigned Flags = kParseNoFlags, detail::AggregateType T>
+    inline Status reflection_from_json(T &&object, const char *str) {
+        return reflection_from_json<Flags>(object, ::std::string_view(str));
+    }
+
+    // Deserialization Interface, projection: only the members of the root object selected by
+    // mask (or named by Fields, tinyrefl::fields<"name", "config">) are read, every other
+    // member is checked and skipped without assignment or allocation
+    template <unsigned Flags = kParseNoFlags, detail::AggregateType T>
+    inline Status reflection_from_json(T &&object, ::std::string_view str, const field_mask<::std::remove_cvref_t<T>> &mask) {
+        detail::BufferStream bs(str.data(), str.size());
+        detail::JsonReader<detail::BufferStream, Flags> reader;
+        const bool ok = reader.parse(bs, object, mask);
+        return make_status(reader, ok, str);
+    }
+
+    template <detail::AggregateType T, typename Fields>
+        requires detail::is_fields_v<Fields>
+    inline Status reflection_from_json(T &object, ::std::string_view str) {
+        return reflection_from_json(object, str, detail::field_mask_v<T, Fields>);
+    }
+
+    // Deserialization Interface, in situ: strings are decoded inside buffer, which is modified.
+    // std::string_view and const char* members of object point into buffer, so it must
+    // outlive them; json_document owns both. Error line/column count the decoded bytes.
+    template <unsigned Flags = kParseNoFlags, detail::AggregateType T, ::std::size_t Extent>
+    inline Status reflection_from_json_insitu(T &&object, ::std::span<char, Extent> buffer) {
+        detail::InsituStream is(buffer.data(), buffer.size());
+        detail::JsonReader<detail::InsituStream, Flags | kParseInsituFlag> reader;
+        const bool ok = reader.parse(is, object);
+        return make_status(reader, ok, ::std::string_view(buffer.data(), buffer.size()));
+    }
+
     // Deserialization Interface
+    template <detail::AggregateType T>
+    inline std::pair<bool, ::std::remove_cvref_t<T>> reflection_from_json(::std::string_view str) {
+        T value{};
+        detail::BufferStream bs(str.data(), str.size());
+        detail::JsonReader<detail::BufferStream> reader;
+        bool ok = reader.parse(bs, value);
+
+        return {ok, ::std::move(value)};
+    }
+
     template <detail::AggregateType T>
     inline std::pair<bool, ::std::remove_cvref_t<T>> reflection_from_json(const char *str) {
-        T value;
-        detail::DispatchHandler handler(value);
-        ::rapidjson::StringStream ss(str);
-        ::rapidjson::Reader reader;
-        auto result = reader.Parse<::rapidjson::kParseDefaultFlags>(ss, handler);
+        return reflection_from_json<T>(::std::string_view(str));
+    }
+
+    template <detail::AggregateType T, typename Fields>
+        requires detail::is_fields_v<Fields>
+    inline std::pair<bool, ::std::remove_cvref_t<T>> reflection_from_json(::std::string_view str) {
+        T value{};
+        const bool ok = reflection_from_json(value, str, detail::field_mask_v<T, Fields>).ok;
+
+        return {ok, ::std::move(value)};
+    }
+
+    struct parse_stats {
+        ::std::size_t key_hits = 0;
+        ::std::size_t key_misses = 0;
+    };
+
+    // Reusable parser for one message type, keep one per thread.
+    // Its scratch buffers survive between parses, so steady-state parsing of
+    // same-shaped messages allocates nothing beyond the target object itself.
+    // With kParseOverwriteFlag a long-lived object is parsed in place: its vectors
+    // and strings keep their capacity, so after warm-up nothing allocates at all.
+    template <detail::AggregateType T, unsigned Flags = kParseNoFlags>
+    class json_parser {
+    public:
+        using value_type = ::std::remove_cvref_t<T>;
+
+    public:
+        Status parse(value_type &object, const char *str) {
+            return parse(object, ::std::string_view(str));
+        }
+
+        Status parse(value_type &object, ::std::string_view str) {
+            detail::BufferStream bs(str.data(), str.size());
+            const bool ok = _reader.parse(bs, object);
+            return make_status(_reader, ok, str);
+        }
+
+        template <typename Char, ::std::size_t Extent>
+            requires ::std::is_same_v<::std::remove_const_t<Char>, char>
+        Status parse(value_type &object, ::std::span<Char, Extent> str) {
+            return parse(object, ::std::string_view(str.data(), str.size()));
+        }
+
+        // read only the root members selected by mask
+        Status parse(value_type &object, ::std::string_view str, const field_mask<value_type> &mask) {
+            detail::BufferStream bs(str.data(), str.size());
+            const bool ok = _reader.parse(bs, object, mask);
+            return make_status(_reader, ok, str);
+        }
+
+        // object keys seen since construction: hits matched the next member in
+        // declaration order, misses (reordered or unknown keys) went through the key index
+        parse_stats stats() const {
+            return {_reader.key_hits(), _reader.key_misses()};
+        }
+
+    private:
+        detail::JsonReader<detail::BufferStream, Flags> _reader;
+    };
+
+    // Lifetime-bound in situ document: owns the buffer that the string_view and
+    // const char* members of value() point into. Every parse starts from a fresh
+    // value, and the buffer is kept between parses, so a long-lived document
+    // allocates nothing for string fields.
+    template <detail::AggregateType T>
+    class json_document {
+    public:
+        using value_type = ::std::remove_cvref_t<T>;
+
+    public:
+        json_document() = default;
+        json_document(json_document &&) = default;
+        json_document &operator=(json_document &&) = default;
+
+        json_document(const json_document &) = delete;
+        json_document &operator=(const json_document &) = delete;
+
+        // copy json into the document buffer and parse it there
+        Status parse(::std::string_view json) {
+            if (_capacity < json.size()) {
+                _buffer.reset(new char[json.size()]);
+                _capacity = json.size();
+            }
+            if (!json.empty()) {
+                ::std::memcpy(_buffer.get(), json.data(), json.size());
+            }
+            return parse_buffer(json.size());
+        }
+
+        // take over a mutable buffer holding length bytes of json
+        Status parse(::std::unique_ptr<char[]> buffer, ::std::size_t length) {
+            _buffer = ::std::move(buffer);
+            _capacity = length;
+            return parse_buffer(length);
+        }
+
+        value_type &value() { return _value; }
+        const value_type &value() const { return _value; }
+
+        value_type *operator->() { return &_value; }
+        const value_type *operator->() const { return &_value; }
+
+    private:
+        Status parse_buffer(::std::size_t length) {
+            _value = value_type{};
+            detail::InsituStream is(_buffer.get(), length);
+            const bool ok = _reader.parse(is, _value);
+            return make_status(_reader, ok, ::std::string_view(_buffer.get(), length));
+        }
+
+    private:
+        ::std::unique_ptr<char[]> _buffer;
+        ::std::size_t _capacity = 0;
+        value_type _value{};
+        detail::JsonReader<detail::InsituStream, kParseInsituFlag> _reader;
+    };
 
-        return {!result.IsError(), value};
+    // Streaming Interface: yields the elements of a root json array one at a time,
+    // reading from a chunked rapidjson input stream such as rapidjson::FileReadStream.
+    // Memory stays bounded by a single element, the yielded reference is valid until the
+    // next increment. Elements of a mismatched json type are skipped. is must outlive the
+    // generator; result() holds the Status once iteration reached end().
+    // kParseOverwriteFlag reads every element into the same object, reusing its capacity
+    template <detail::AggregateType T, unsigned Flags = kParseNoFlags, typename Stream>
+    inline generator<::std::remove_cvref_t<T>, Status> json_stream(Stream &is) {
+        using value_type = ::std::remove_cvref_t<T>;
+
+        detail::JsonReader<Stream, Flags> reader;
+        value_type value{};
+        bool end = false;
+        bool ok = reader.begin_array(is, end);
+        while (ok && !end) {
+            if constexpr ((Flags & kParseOverwriteFlag) == 0) {
+                value = value_type{};
+            }
+            bool read = false;
+            ok = reader.read_element(value, read);
+            if (ok && read) {
+                co_yield value;
+            }
+            ok = ok && reader.end_element(end);
+        }
+        co_return make_status(reader, ok);
+    }
+
+    // malformed line of a newline delimited json batch
+    struct ndjson_error {
+        ::std::size_t index = 0;  // 0-based line index in the buffer
+        Error error;              // offset into the whole buffer, line is index + 1
+    };
+
+    struct ndjson_status {
+        bool ok = true;
+        ::std::size_t lines = 0;
+        ::std::vector<ndjson_error> errors;
+
+        operator bool() { return ok; }
+    };
+
+} // end tinyrefl namespace
+
+namespace tinyrefl::detail
+{
+    // parsed lines of one chunk, error indices count from the chunk's first line
+    template <typename T>
+    struct ndjson_chunk {
+        const char *first = nullptr;
+        const char *last = nullptr;
+        ::std::size_t lines = 0;
+        ::std::vector<T> values;
+        ::std::vector<ndjson_error> errors;
+    };
+
+    inline bool is_blank_line(const char *first, const char *last) {
+        for (; first != last; ++first) {
+            if (*first != ' ' && *first != '\t' && *first != '\r') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename T>
+    void parse_ndjson_chunk(ndjson_chunk<T> &chunk, const char *buffer) {
+        JsonReader<BufferStream> reader;
+        for (const char *line = chunk.first; line != chunk.last; ++chunk.lines) {
+            const char *newline = find_newline(line, chunk.last);
+            if (!is_blank_line(line, newline)) {
+                const ::std::size_t length = static_cast<::std::size_t>(newline - line);
+                BufferStream bs(line, length);
+                T &value = chunk.values.emplace_back();
+                const bool ok = reader.parse(bs, value);
+                if (!ok) {
+                    chunk.values.pop_back();
+                    Status st = make_status(reader, ok, ::std::string_view(line, length));
+                    st.error.offset += static_cast<::std::size_t>(line - buffer);
+                    chunk.errors.push_back({chunk.lines, ::std::move(st.error)});
+                }
+            }
+            line = newline != chunk.last ? newline + 1 : newline;
+        }
+    }
+} // end tinyrefl::detail namespace
+
+namespace tinyrefl {
+    // Deserialization Interface, newline delimited json: one T per line, appended to out in
+    // line order. The buffer is cut into chunks at newlines found with a SIMD scan, and the
+    // chunks are parsed on up to threads workers (0: one per hardware thread).
+    // A malformed line is left out of out and reported with its index, the rest of the batch
+    // is still parsed. Blank lines are skipped but counted.
+    template <detail::AggregateType T>
+    inline ndjson_status parse_ndjson(::std::string_view buffer, ::std::vector<T> &out, unsigned threads = 0) {
+        // below this a chunk is not worth a thread
+        constexpr ::std::size_t min_chunk_size = 64 * 1024;
+
+        threads = detail::resolve_threads(threads);
+        const ::std::size_t chunk_count = ::std::clamp<::std::size_t>(
+            buffer.size() / min_chunk_size, 1, threads == 1 ? 1 : ::std::size_t(threads) * 4);
+
+        const char *first = buffer.data();
+        const char *last = first + buffer.size();
+        ::std::vector<detail::ndjson_chunk<T>> chunks(chunk_count);
+        for (::std::size_t i = 0; i < chunk_count; ++i) {
+            chunks[i].first = i ? chunks[i - 1].last : first;
+            const char *cut = first + buffer.size() / chunk_count * (i + 1);
+            if (i + 1 == chunk_count || cut <= chunks[i].first) {
+                chunks[i].last = i + 1 == chunk_count ? last : chunks[i].first;
+            }
+            else {
+                const char *newline = detail::find_newline(cut - 1, last);
+                chunks[i].last = newline != last ? newline + 1 : last;
+            }
+        }
+
+        detail::parallel_for(chunk_count, threads, [&](::std::size_t i) {
+            detail::parse_ndjson_chunk(chunks[i], first);
+        });
+
+        ndjson_status status;
+        ::std::size_t total = 0;
+        for (const auto &chunk : chunks) {
+            total += chunk.values.size();
+        }
+        out.reserve(out.size() + total);
+        for (auto &chunk : chunks) {
+            ::std::move(chunk.values.begin(), chunk.values.end(), ::std::back_inserter(out));
+            for (ndjson_error &error : chunk.errors) {
+                error.index += status.lines;
+                error.error.line = error.index + 1;
+                status.errors.push_back(::std::move(error));
+            }
+            status.lines += chunk.lines;
+        }
+        status.ok = status.errors.empty();
+        return status;
     }
 
 } // end tinyrefl namespace
@@ -1,14 +1,32 @@
 #include "utils/reflection_tuple_foreach.hpp"
+#include "utils/reflection_json_number.hpp"
+#include "utils/reflection_json_escape.hpp"
+#include "utils/reflection_json_writer.hpp"
+#include "utils/reflection_field_mask.hpp"
+#include "utils/reflection_parallel.hpp"
+
+#include <span>
+#include <vector>
+#include <unordered_map>
 
 namespace tinyrefl {
 
 template <detail::AggregateType T, detail::OutputStream Stream>
 inline void reflection_to_json(T&& object, Stream &stream);
+
+template <detail::AggregateType T, detail::OutputStream Stream>
+inline void reflection_to_json(T&& object, Stream &stream, const field_mask<::std::remove_cvref_t<T>>& mask);
+
+template <detail::AggregateType T>
+inline size_t json_size(const T& object);
 }
 
 namespace tinyrefl::detail {
 
 // declear
+template <OutputStream Stream, typename T>
+inline void to_json_object(Stream& s, T&& object);
+
 template <OutputStream Stream, typename T>
 inline void to_json_value(Stream&& s, T&& object) requires is_custom_type_v<T>;
 
@@ -19,7 +37,7 @@ template <OutputStream Stream, typename T>
 inline void to_json_value(Stream&& s, T&& object) requires is_associative_container_v<T>;
 
 template <OutputStream Stream, typename T>
-inline void to_json_value(Stream&& s, T&& object) requires is_string_v<T>;
+inline void to_json_value(Stream&& s, T&& object) requires (is_string_v<T> || is_string_view_v<T>);
 
 template <OutputStream Stream, typename T>
 inline void to_json_value(Stream&& s, T&& object) requires is_char_v<T>;
@@ -35,23 +53,92 @@ requires (is_int_v<T> || is_int64_v<T> || is_floating_v<T>)
 inline void to_json_value(Stream&& s, T&& object);
 
 // implement
+
+// '{', '}', every "key": and the commas between members, known at compile time
+template <typename T, size_t... Is>
+consteval size_t json_keys_size(::std::index_sequence<Is...>) {
+    constexpr auto member_name_arr = struct_members_to_array<T>();
+    constexpr size_t count = sizeof...(Is);
+    return 2 + ((member_name_arr[Is].size() + 3) + ... + 0) + (count > 0 ? count - 1 : 0);
+}
+
 template <typename T>
-concept KeyValue = requires(const T& t) {
-    { t.data() };
-    { t.size() };
+inline constexpr size_t json_keys_size_v = json_keys_size<remove_cvref_t<T>>(serializable_indices_t<remove_cvref_t<T>>{});
+
+// pre-rendered key fragments of T, all of them back to back in one constant buffer
+template <size_t Count, size_t Size>
+struct json_key_fragments {
+    static constexpr size_t count = Count;
+
+    ::std::array<char, Size> data{};
+    ::std::array<size_t, Count + 1> offsets{};
+
+    constexpr ::std::string_view fragment(size_t index) const {
+        return ::std::string_view(data.data() + offsets[index], offsets[index + 1] - offsets[index]);
+    }
 };
 
-template <OutputStream Stream, KeyValue Value>
-inline void to_json_key(Stream&& s, Value&& value) {
-    s.append("\"");
-    s.append(value.data(), value.size() );
-    s.append("\"");
+template <typename T, size_t... Is>
+consteval auto make_json_key_fragments(::std::index_sequence<Is...>) {
+    constexpr auto member_name_arr = struct_members_to_array<T>();
+    json_key_fragments<sizeof...(Is), json_keys_size_v<T> - 1> result;
+
+    size_t pos = 0;
+    size_t index = 0;
+    auto put = [&](char c) { result.data[pos++] = c; };
+    ([&] {
+        result.offsets[index] = pos;
+        put(index++ == 0 ? '{' : ',');
+        put('"');
+        for (char c : member_name_arr[Is]) {
+            put(c);
+        }
+        put('"');
+        put(':');
+    }(), ...);
+    result.offsets[index] = pos;
+    return result;
+}
+
+template <typename T>
+inline constexpr auto json_key_fragments_v = make_json_key_fragments<remove_cvref_t<T>>(serializable_indices_t<remove_cvref_t<T>>{});
+
+// from this length on a string is sized exactly before it is written: one more scan is cheaper
+// than preparing (and leaving the sink at) six times its length
+inline constexpr size_t json_string_exact_size_min = 1024;
+
+// string through the raw pointer when the stream allows it
+template <OutputStream Stream>
+inline void to_json_string(Stream& s, const char* str, size_t length) {
+    if constexpr (RawOutputStream<Stream>) {
+        const size_t size = length < json_string_exact_size_min ? json_string_max_size(length) : json_string_size(str, length);
+        s.commit(write_json_string(s.prepare(size), str, length));
+    }
+    else {
+        write_json_string(s, str, length);
+    }
+}
+
+// number or bool into a json_number_max_length buffer
+template <typename T>
+inline char* write_json_scalar(char* buffer, const T& value) {
+    if constexpr (is_bool_v<T>) {
+        if (value) {
+            ::std::memcpy(buffer, "true", 4);
+            return buffer + 4;
+        }
+        ::std::memcpy(buffer, "false", 5);
+        return buffer + 5;
+    }
+    else {
+        return write_json_number(buffer, value);
+    }
 }
 
 // to_json_value main template, recursion reslove custom type
 template <OutputStream Stream, typename T>
 inline void to_json_value(Stream&& s, T&& object) requires is_custom_type_v<T> {
-    ::tinyrefl::reflection_to_json(object, s);
+    to_json_object(s, object);
 }
 // sequence to json
 template <OutputStream Stream, typename T>
@@ -69,8 +156,8 @@ inline void to_json_value(Stream&& s, T&& object) requires is_associative_contai
     s.append("{");
     for_each_by_iterator(s, object.cbegin(), object.cend(), ",", [&](const auto& pair_value) {  // ::std::pair
         if constexpr (is_string_v<decltype(pair_value.first)>) {
-            to_json_key(s, pair_value.first);
-            s.append(":");
+            to_json_string(s, pair_value.first.data(), pair_value.first.size());
+            s.append(":", 1);
             to_json_value(s, pair_value.second);
         } else {
             static_assert(is_string_v<decltype(pair_value.first)>, "Only string keys are supported in JSON");
@@ -79,25 +166,27 @@ inline void to_json_value(Stream&& s, T&& object) requires is_associative_contai
     s.append("}");
 }
 
-// string to json
+// string, string_view to json
 template <OutputStream Stream, typename T>
-inline void to_json_value(Stream&& s, T&& object) requires is_string_v<T> {
-    s.append("\"");
-    s.append(object.data(), object.size());
-    s.append("\"");
+inline void to_json_value(Stream&& s, T&& object) requires (is_string_v<T> || is_string_view_v<T>) {
+    to_json_string(s, object.data(), object.size());
 }
 
 // char to json
 template <OutputStream Stream, typename T>
 inline void to_json_value(Stream&& s, T&& object) requires is_char_v<T> {
-    s.append("\"");
-    s.push_back(object);
-    s.append("\"");
+    const char c = static_cast<char>(object);
+    to_json_string(s, &c, 1);
 }
 
 template <OutputStream Stream, typename T>
 inline void to_json_value(Stream&& s, T&& object) requires is_bool_v<T> {
-    s.append(object ? "true" : "false");
+    if (object) {
+        s.append("true", 4);
+    }
+    else {
+        s.append("false", 5);
+    }
 }
 
 // char* to json
@@ -110,56 +199,318 @@ inline void to_json_value(Stream&& s, T&& object) requires is_char_pointer_v<T>
         s.append("null", 4);
         return;
     }
-    s.append("\"", 1);
-    while (*str) {
-        switch (*str) {
-            case '"':  s.append("\\\"", 2); break;
-            case '\\': s.append("\\\\", 2); break;
-            case '\b': s.append("\\b", 2);  break;
-            case '\f': s.append("\\f", 2);  break;
-            case '\n': s.append("\\n", 2);  break;
-            case '\r': s.append("\\r", 2);  break;
-            case '\t': s.append("\\t", 2);  break;
-            default:
-                if (static_cast<unsigned char>(*str) < 0x20) {
-                    char buffer[7];
-                    ::std::snprintf(buffer, sizeof(buffer), "\\u%04X", static_cast<unsigned char>(*str));
-                    s.append(buffer, 6);
-                } else {
-                    s.append(str, 1);
-                }
-                break;
+    to_json_string(s, str, ::std::strlen(str));
+}
+
+// number to json
+template <OutputStream Stream, typename T>
+requires (is_int_v<T> || is_int64_v<T> || is_floating_v<T>)
+inline void to_json_value(Stream&& s, T&& object) {
+    if constexpr (RawOutputStream<remove_cvref_t<Stream>>) {
+        s.commit(write_json_number(s.prepare(json_number_max_length), object));
+    }
+    else {
+        char buffer[json_number_max_length];
+        const char* end = write_json_number(buffer, object);
+        s.append(buffer, static_cast<size_t>(end - buffer));
+    }
+}
+
+// "key": and the value of one member, key is a pre-rendered fragment with its '{' or ','
+template <OutputStream Stream, typename M>
+inline void to_json_member(Stream& s, ::std::string_view key, const M& member) {
+    using MemberType = remove_cvref_t<M>;
+    if constexpr (RawOutputStream<Stream> && (is_int_v<MemberType> || is_int64_v<MemberType> ||
+        is_floating_v<MemberType> || is_bool_v<MemberType>)) {
+        // key and scalar value in one worst-case chunk, committed once
+        char* p = s.prepare(key.size() + json_number_max_length);
+        ::std::memcpy(p, key.data(), key.size());
+        s.commit(write_json_scalar(p + key.size(), member));
+    }
+    else {
+        s.append(key.data(), key.size());
+        to_json_value(s, member);
+    }
+}
+
+// custom type to json, reflection_to_json sizes the sink once (unless it sizes itself) then comes here for every nested object
+template <OutputStream Stream, typename T>
+inline void to_json_object(Stream& s, T&& object) {
+    using U = remove_cvref_t<T>;
+    constexpr auto& fragments = json_key_fragments_v<U>;
+
+    if constexpr (fragments.count == 0) {
+        s.append("{}", 2);
+    }
+    else {
+        // one append per key: {"name": for the first member, ,"name": for the rest
+        for_each_serializable_member(::std::forward<T>(object), [&](auto&& member_reference,
+            auto&&, auto&& member_index) {
+                to_json_member(s, fragments.fragment(member_index), member_reference);
+            });
+        s.append("}", 1);
+    }
+}
+
+// member writer table, position i writes the i-th index in serializable_indices_t<T>
+template <typename Stream, typename T, size_t I>
+inline void write_member(Stream& s, const T& object, ::std::string_view key) {
+    to_json_member(s, key, struct_member_reference<I>(object));
+}
+
+template <typename Stream, typename T, size_t... Is>
+consteval auto make_member_writer_table(::std::index_sequence<Is...>) {
+    using WriteFunction = void (*)(Stream&, const T&, ::std::string_view);
+    return ::std::array<WriteFunction, sizeof...(Is)>{ &write_member<Stream, T, Is>... };
+}
+
+template <typename Stream, typename T>
+inline constexpr auto member_writer_table_v = make_member_writer_table<Stream, T>(serializable_indices_t<T>{});
+
+// Emission plan of one field_mask: the selected members in order, each with its key
+// fragment already carrying the right '{' or ','
+template <typename Stream, typename T>
+struct json_emission_plan {
+    using WriteFunction = void (*)(Stream&, const T&, ::std::string_view);
+
+    struct step {
+        ::std::string_view key;
+        WriteFunction write;
+    };
+
+    ::std::string keys;
+    ::std::vector<step> steps;
+
+    explicit json_emission_plan(const field_mask<T>& mask) {
+        constexpr auto& fragments = json_key_fragments_v<T>;
+        constexpr auto& writers = member_writer_table_v<Stream, T>;
+
+        ::std::vector<size_t> offsets;
+        for (size_t i = 0; i < fragments.count; ++i) {
+            if (mask.test(i)) {
+                // every fragment but the first starts with ',', the first one with '{'
+                const auto fragment = fragments.fragment(i);
+                offsets.push_back(keys.size());
+                keys += steps.empty() ? '{' : ',';
+                keys.append(fragment.data() + 1, fragment.size() - 1);
+                steps.push_back({ {}, writers[i] });
+            }
+        }
+        offsets.push_back(keys.size());
+        for (size_t i = 0; i < steps.size(); ++i) {
+            steps[i].key = ::std::string_view(keys.data() + offsets[i], offsets[i + 1] - offsets[i]);
         }
-        ++str;
     }
-    s.append("\"", 1);
+
+    json_emission_plan(const json_emission_plan&) = delete;
+    json_emission_plan& operator=(const json_emission_plan&) = delete;
+};
+
+template <typename T>
+struct field_mask_hash {
+    size_t operator()(const field_mask<T>& mask) const {
+        ::std::uint64_t h = 0;
+        for (auto word : mask.words()) {
+            h = key_hash_mix(h ^ word);
+        }
+        return static_cast<size_t>(h);
+    }
+};
+
+// Plans are cached per thread and per distinct mask, so a repeated mask costs one hash
+// lookup. The cache is dropped when it outgrows max_cached_plans distinct masks.
+inline constexpr size_t max_cached_plans = 256;
+
+template <typename Stream, typename T>
+inline const json_emission_plan<Stream, T>& emission_plan(const field_mask<T>& mask) {
+    thread_local ::std::unordered_map<field_mask<T>, json_emission_plan<Stream, T>, field_mask_hash<T>> plans;
+
+    auto it = plans.find(mask);
+    if (it == plans.end()) {
+        if (plans.size() >= max_cached_plans) {
+            plans.clear();
+        }
+        it = plans.try_emplace(mask, mask).first;
+    }
+    return it->second;
 }
 
-// int to json
+// only the members selected by mask, replayed from the cached plan
 template <OutputStream Stream, typename T>
+inline void to_json_object(Stream& s, const T& object, const field_mask<T>& mask) {
+    const auto& plan = emission_plan<Stream, T>(mask);
+    if (plan.steps.empty()) {
+        s.append("{}", 2);
+        return;
+    }
+    for (const auto& step : plan.steps) {
+        step.write(s, object, step.key);
+    }
+    s.append("}", 1);
+}
+
+// json size, walks the same members as to_json_value
+template <typename T>
+inline size_t json_size_value(const T& object) requires is_custom_type_v<T>;
+
+template <typename T>
+inline size_t json_size_value(const T& object) requires is_sequence_container_v<T>;
+
+template <typename T>
+inline size_t json_size_value(const T& object) requires is_associative_container_v<T>;
+
+template <typename T>
+inline size_t json_size_value(const T& object) requires (is_string_v<T> || is_string_view_v<T>);
+
+template <typename T>
+inline size_t json_size_value(const T& object) requires is_char_v<T>;
+
+template <typename T>
+inline size_t json_size_value(const T& object) requires is_bool_v<T>;
+
+template <typename T>
+inline size_t json_size_value(const T& object) requires is_char_pointer_v<T>;
+
+template <typename T>
 requires (is_int_v<T> || is_int64_v<T> || is_floating_v<T>)
-inline void to_json_value(Stream&& s, T&& object) {
-    s.append(::std::to_string(object));
+inline size_t json_size_value(const T& object);
+
+template <typename T>
+inline size_t json_size_value(const T& object) requires is_custom_type_v<T> {
+    size_t size = json_keys_size_v<T>;
+    for_each_serializable_member(object, [&](auto&& member_reference, auto&&, auto&&) {
+        size += json_size_value(member_reference);
+    });
+    return size;
+}
+
+template <typename T>
+inline size_t json_size_value(const T& object) requires is_sequence_container_v<T> {
+    size_t size = 2;
+    for (const auto& member : object) {
+        size += json_size_value(member) + 1;
+    }
+    return object.empty() ? size : size - 1;
+}
+
+template <typename T>
+inline size_t json_size_value(const T& object) requires is_associative_container_v<T> {
+    size_t size = 2;
+    for (const auto& pair_value : object) {
+        size += json_string_size(pair_value.first.data(), pair_value.first.size()) + 1 + json_size_value(pair_value.second) + 1;
+    }
+    return object.empty() ? size : size - 1;
+}
+
+template <typename T>
+inline size_t json_size_value(const T& object) requires (is_string_v<T> || is_string_view_v<T>) {
+    return json_string_size(object.data(), object.size());
+}
+
+template <typename T>
+inline size_t json_size_value(const T& object) requires is_char_v<T> {
+    const char c = static_cast<char>(object);
+    return json_string_size(&c, 1);
+}
+
+template <typename T>
+inline size_t json_size_value(const T& object) requires is_bool_v<T> {
+    return object ? 4 : 5;
+}
+
+template <typename T>
+inline size_t json_size_value(const T& object) requires is_char_pointer_v<T> {
+    const char* str = object;
+    return str == nullptr ? 4 : json_string_size(str, ::std::strlen(str));
+}
+
+template <typename T>
+requires (is_int_v<T> || is_int64_v<T> || is_floating_v<T>)
+inline size_t json_size_value(const T& object) {
+    return json_number_size(object);
 }
     
 }  // end namespace tinyrefl::detail
 
 namespace tinyrefl {
+    // Serialized size of object: exact, except float/double members which count their longest form
+    template <detail::AggregateType T>
+    inline size_t json_size(const T& object) {
+        return detail::json_size_value(object);
+    }
+
     template <detail::AggregateType T, detail::OutputStream Stream>
     inline void reflection_to_json(T&& object, Stream& stream) {
-	    constexpr size_t serializable_count = detail::serializable_members_count_v<detail::remove_cvref_t<T>>;
-
-	    stream.append("{");
-	    detail::for_each_serializable_member(::std::forward<T>(object), [&](auto&& member_reference,
-		    auto&& member_name, auto&& member_index) {
-			    detail::to_json_key(stream, member_name);
-			    stream.append(":");
-			    detail::to_json_value(stream, member_reference);
-			    if (member_index < serializable_count - 1) {
-				    stream.append(",");
-			    }
-		    });
-	    stream.append("}");
+        if constexpr (::std::is_same_v<Stream, ::std::string>) {
+            // std::string sinks are written through json_writer
+            json_writer writer(stream);
+            reflection_to_json(object, writer);
+        }
+        else {
+            // size the sink once instead of letting appends regrow it; raw output streams such
+            // as json_writer prepare worst-case chunks themselves, a pre-pass would only walk
+            // the object twice
+            if constexpr (!detail::RawOutputStream<Stream> && requires { stream.reserve(stream.size() + 1); }) {
+                stream.reserve(stream.size() + json_size(object));
+            }
+            detail::to_json_object(stream, object);
+        }
+    }
+
+    // Serialize only the members selected by mask, e.g. the fields a client asked for.
+    // Nested members are written whole. See detail::emission_plan for the plan cache.
+    template <detail::AggregateType T, detail::OutputStream Stream>
+    inline void reflection_to_json(T&& object, Stream& stream, const field_mask<::std::remove_cvref_t<T>>& mask) {
+        if constexpr (::std::is_same_v<Stream, ::std::string>) {
+            json_writer writer(stream);
+            reflection_to_json(object, writer, mask);
+        }
+        else {
+            detail::to_json_object(stream, object, mask);
+        }
+    }
+
+    // Serialize objects as newline delimited json, one line per object. Chunks of objects are
+    // written in parallel on up to threads workers (0: one per hardware thread), each into
+    // its own buffer, then handed to sink in order: all at once to a gather sink such as
+    // fd_writer, appended one after the other to any other OutputStream.
+    // T is not deduced from a std::vector, call it as to_ndjson<T>(objects, sink)
+    template <detail::AggregateType T, typename Sink>
+        requires (detail::GatherOutputStream<Sink> || detail::OutputStream<Sink>)
+    inline void to_ndjson(::std::span<const T> objects, Sink& sink, unsigned threads = 0) {
+        // below this a chunk is not worth a thread
+        constexpr size_t min_chunk_objects = 256;
+
+        threads = detail::resolve_threads(threads);
+        const size_t chunk_count = ::std::clamp<size_t>(
+            objects.size() / min_chunk_objects, 1, threads == 1 ? 1 : size_t(threads) * 4);
+
+        ::std::vector<::std::string> chunks(chunk_count);
+        detail::parallel_for(chunk_count, threads, [&](size_t i) {
+            json_writer writer(chunks[i]);
+            const size_t last = objects.size() * (i + 1) / chunk_count;
+            for (size_t j = objects.size() * i / chunk_count; j < last; ++j) {
+                reflection_to_json(objects[j], writer);
+                writer.push_back('\n');
+            }
+        });
+
+        if constexpr (detail::GatherOutputStream<Sink>) {
+            const ::std::vector<::std::string_view> parts(chunks.begin(), chunks.end());
+            sink.write(parts);
+        }
+        else {
+            if constexpr (requires { sink.reserve(sink.size() + 1); }) {
+                size_t size = sink.size();
+                for (const auto& chunk : chunks) {
+                    size += chunk.size();
+                }
+                sink.reserve(size);
+            }
+            for (const auto& chunk : chunks) {
+                sink.append(chunk.data(), chunk.size());
+            }
+        }
     }
 
 }  // end namespace tinyrefl
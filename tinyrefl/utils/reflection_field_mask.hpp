@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <initializer_list>
+
+#include "reflection_key_index.hpp"
+
+namespace tinyrefl::detail {
+
+	// string literal as a template argument: fields<"name", "config">
+	template <::std::size_t N>
+	struct fixed_string {
+		char data[N]{};
+
+		consteval fixed_string(const char (&str)[N]) {
+			for (::std::size_t i = 0; i < N; ++i) {
+				data[i] = str[i];
+			}
+		}
+
+		constexpr ::std::string_view view() const { return ::std::string_view(data, N - 1); }
+	};
+
+}  // end namespace tinyrefl::detail
+
+namespace tinyrefl {
+
+	// compile time projection, only the named members are read
+	template <detail::fixed_string... Names>
+	struct fields {};
+
+	// Runtime set of serializable members of T.
+	// Position i is the i-th index in serializable_indices_t<T>, the same
+	// position member_key_index_v<T> returns for the member name.
+	template <typename T>
+	class field_mask {
+	public:
+		static constexpr ::std::size_t size = detail::serializable_members_count_v<detail::remove_cvref_t<T>>;
+		static constexpr ::std::size_t word_count = (size + 63) / 64;
+
+	public:
+		constexpr field_mask() = default;
+
+		// unknown names are ignored, use set() to detect them
+		constexpr field_mask(::std::initializer_list<::std::string_view> names) {
+			for (auto name : names) {
+				set(name);
+			}
+		}
+
+		static constexpr field_mask all() {
+			field_mask mask;
+			for (::std::size_t i = 0; i < size; ++i) {
+				mask.set(i);
+			}
+			return mask;
+		}
+
+		// false if T has no serializable member called name
+		constexpr bool set(::std::string_view name) {
+			const ::std::size_t pos = detail::member_key_index_v<T>.find(name);
+			if (pos >= size) {
+				return false;
+			}
+			set(pos);
+			return true;
+		}
+
+		constexpr void set(::std::size_t pos) { _words[pos / 64] |= ::std::uint64_t(1) << (pos % 64); }
+		constexpr void reset(::std::size_t pos) { _words[pos / 64] &= ~(::std::uint64_t(1) << (pos % 64)); }
+		constexpr bool test(::std::size_t pos) const { return (_words[pos / 64] >> (pos % 64)) & 1; }
+
+		constexpr ::std::size_t count() const {
+			::std::size_t n = 0;
+			for (auto word : _words) {
+				n += static_cast<::std::size_t>(::std::popcount(word));
+			}
+			return n;
+		}
+
+		constexpr const ::std::array<::std::uint64_t, word_count>& words() const { return _words; }
+
+		constexpr bool operator==(const field_mask&) const = default;
+
+	private:
+		::std::array<::std::uint64_t, word_count> _words{};
+	};
+
+}  // end namespace tinyrefl
+
+namespace tinyrefl::detail {
+
+	template <typename Fields>
+	inline constexpr bool is_fields_v = false;
+
+	template <fixed_string... Names>
+	inline constexpr bool is_fields_v<::tinyrefl::fields<Names...>> = true;
+
+	template <typename T, fixed_string... Names>
+	consteval ::tinyrefl::field_mask<T> make_field_mask(::tinyrefl::fields<Names...>) {
+		::tinyrefl::field_mask<T> mask;
+		auto set = [&](::std::string_view name) {
+			if (!mask.set(name)) {
+				throw "fields<...> names a member that is not serializable";
+			}
+		};
+		(set(Names.view()), ...);
+		return mask;
+	}
+
+	template <typename T, typename Fields>
+	inline constexpr ::tinyrefl::field_mask<T> field_mask_v = make_field_mask<remove_cvref_t<T>>(Fields{});
+
+}  // end namespace tinyrefl::detail
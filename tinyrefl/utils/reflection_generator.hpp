@@ -0,0 +1,118 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <utility>
+#include <cstddef>
+
+namespace tinyrefl {
+
+	// Minimal C++20 coroutine generator, until std::generator is available everywhere.
+	// Yields references to a T owned by the coroutine frame: each one is valid until the
+	// next increment. The value passed to co_return is kept and read back with result()
+	// once iteration reached end().
+	template <typename T, typename Result>
+	class generator {
+	public:
+		struct promise_type {
+			T* _current = nullptr;
+			Result _result{};
+			::std::exception_ptr _exception;
+
+			generator get_return_object() {
+				return generator(::std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+
+			::std::suspend_always initial_suspend() noexcept { return {}; }
+			::std::suspend_always final_suspend() noexcept { return {}; }
+
+			::std::suspend_always yield_value(T& value) noexcept {
+				_current = &value;
+				return {};
+			}
+
+			void return_value(Result result) { _result = ::std::move(result); }
+			void unhandled_exception() { _exception = ::std::current_exception(); }
+
+			// no co_await inside a generator
+			template <typename U>
+			void await_transform(U&&) = delete;
+		};
+
+		using handle_type = ::std::coroutine_handle<promise_type>;
+
+		class iterator {
+		public:
+			using iterator_category = ::std::input_iterator_tag;
+			using difference_type = ::std::ptrdiff_t;
+			using value_type = T;
+
+		public:
+			iterator() = default;
+			explicit iterator(handle_type handle) : _handle(handle) {}
+
+			T& operator*() const { return *_handle.promise()._current; }
+			T* operator->() const { return _handle.promise()._current; }
+
+			iterator& operator++() {
+				resume(_handle);
+				return *this;
+			}
+			void operator++(int) { ++*this; }
+
+			bool operator==(::std::default_sentinel_t) const { return !_handle || _handle.done(); }
+
+		private:
+			handle_type _handle = nullptr;
+		};
+
+	public:
+		generator(generator&& other) noexcept : _handle(::std::exchange(other._handle, nullptr)) {}
+		generator& operator=(generator&& other) noexcept {
+			if (this != &other) {
+				destroy();
+				_handle = ::std::exchange(other._handle, nullptr);
+			}
+			return *this;
+		}
+
+		generator(const generator&) = delete;
+		generator& operator=(const generator&) = delete;
+
+		~generator() { destroy(); }
+
+	public:
+		// single pass: begin() runs the coroutine up to its first co_yield
+		iterator begin() {
+			resume(_handle);
+			return iterator(_handle);
+		}
+		::std::default_sentinel_t end() const { return {}; }
+
+		// the co_return value, meaningful once iteration reached end()
+		const Result& result() const { return _handle.promise()._result; }
+
+	private:
+		explicit generator(handle_type handle) : _handle(handle) {}
+
+		static void resume(handle_type handle) {
+			if (handle && !handle.done()) {
+				handle.resume();
+				if (handle.promise()._exception) {
+					::std::rethrow_exception(::std::exchange(handle.promise()._exception, nullptr));
+				}
+			}
+		}
+
+		void destroy() {
+			if (_handle) {
+				_handle.destroy();
+			}
+		}
+
+	private:
+		handle_type _handle = nullptr;
+	};
+
+}  // end namespace tinyrefl
@@ -2,17 +2,21 @@
 
 #include <variant>
 
-#include "tinyrefl/thirdparty/frozen/string.h"
 #include "reflection_utils.hpp"
-#include "tinyrefl/thirdparty/frozen/unordered_map.h"
 
 namespace tinyrefl::detail {
 
+	// Declared, never defined: get_tuple() only takes the addresses of its members, as
+	// template arguments for the name extraction, so no object of T is ever materialized,
+	// initialized at startup or kept in memory, and T need not be default constructible.
 	template <typename T>
 	struct Wrapper {
-		inline static remove_cvref_t<T> value;
+		T value;
 	};
 
+	template <typename T>
+	extern const Wrapper<remove_cvref_t<T>> external_value;
+
 	struct Any {
 		constexpr Any(int) {}
 
@@ -31,108 +35,121 @@ namespace tinyrefl::detail {
 		operator T();
 	};
 
+	// T{ Any... } with N initializers. Any converts to every member type but C arrays,
+	// whose elements are initialized one Any each by brace elision instead.
 	template<typename T, ::std::size_t N>
-	constexpr auto test() {
+	constexpr bool test() {
 		return[]<::std::size_t... I>(::std::index_sequence<I...>) {
 			return requires{ T{ Any(I)... }; };
 		}(::std::make_index_sequence<N>{});
 	}
 
-	template<typename T, int N = 0>
-	constexpr auto member_count() {
-		if constexpr (test<T, N>() && !test<T, N + 1>()) {
+	// T{ Any x N1, { Any }, Any x N3 }: the braced initializer takes exactly one member
+	template<typename T, ::std::size_t N1, ::std::size_t N3>
+	constexpr bool test_braced() {
+		return[]<::std::size_t... I1, ::std::size_t... I3>(::std::index_sequence<I1...>, ::std::index_sequence<I3...>) {
+			return requires{ T{ Any(I1)..., { Any(0) }, Any(I3)... }; };
+		}(::std::make_index_sequence<N1>{}, ::std::make_index_sequence<N3>{});
+	}
+
+	// T{ { Any } x N }
+	template<typename T, ::std::size_t N>
+	constexpr bool test_all_braced() {
+		return[]<::std::size_t... I>(::std::index_sequence<I...>) {
+			return requires{ T{ { Any(I) }... }; };
+		}(::std::make_index_sequence<N>{});
+	}
+
+	// smallest valid count: only members that must be initialized explicitly make smaller ones fail
+	template <typename T, ::std::size_t N = 0>
+	constexpr ::std::size_t first_valid_count() {
+		static_assert(N <= sizeof(T), "can not count the members of T");
+		if constexpr (test<T, N>()) {
 			return N;
 		}
 		else {
-			return member_count<T, N + 1>();
+			return first_valid_count<T, N + 1>();
 		}
 	}
 
-	template<typename T, ::std::size_t N1, ::std::size_t N2, ::std::size_t N3>
-	constexpr bool test_three_parts() {
-		return[]<::std::size_t... I1, ::std::size_t... I2, ::std::size_t... I3>(::std::index_sequence<I1...>,
-			::std::index_sequence<I2...>,
-			::std::index_sequence<I3...>) {
-			return requires{ T{ Any(I1)..., { Any(I2)... }, Any(I3)... }; };
-		}(::std::make_index_sequence<N1>{}, ::std::make_index_sequence<N2>{}, ::std::make_index_sequence<N3>{});
-	}
-
-	// try insert N Ant{} to pos
-	template<typename T, ::std::size_t position, ::std::size_t N>
-	constexpr bool try_place_n_in_pos() {
-		constexpr auto Total = member_count<T>();
-		if constexpr (N == 0) {
-			return true;
+	// largest N in [Lo, Hi) with Valid<N>, given Valid<Lo> and !Valid<Hi>
+	template <::std::size_t Lo, ::std::size_t Hi, typename Valid>
+	constexpr ::std::size_t bisect_count(Valid valid) {
+		if constexpr (Hi - Lo <= 1) {
+			return Lo;
 		}
-		else if constexpr (position + N <= Total) {
-			return test_three_parts<T, position, N, Total - position - N>();
+		else if constexpr (valid.template operator()<Lo + (Hi - Lo) / 2>()) {
+			return bisect_count<Lo + (Hi - Lo) / 2, Hi>(valid);
 		}
 		else {
-			return false;
+			return bisect_count<Lo, Lo + (Hi - Lo) / 2>(valid);
 		}
 	}
 
-	// try pos max count
-	template <typename T, ::std::size_t pos, ::std::size_t N = 0, ::std::size_t Max = 10>
-	constexpr bool has_extra_elements() {
-		constexpr auto Total = member_count<T>();
-		if constexpr (test_three_parts<T, pos, N, Total - pos - 1>()) {
-			return false;
-		}
-		else if constexpr (N + 1 <= Max) {
-			return has_extra_elements<T, pos, N + 1>();
+	// largest N >= Lo with Valid<N>, given Valid<Lo>: doubling steps bracket it, then bisection,
+	// O(log n) probes in all
+	template <::std::size_t Lo, ::std::size_t Step = 1, typename Valid>
+	constexpr ::std::size_t gallop_count(Valid valid) {
+		if constexpr (valid.template operator()<Lo + Step>()) {
+			return gallop_count<Lo + Step, Step * 2>(valid);
 		}
 		else {
-			return true;
+			return bisect_count<Lo, Lo + Step>(valid);
 		}
 	}
 
-	template<typename T, ::std::size_t pos, ::std::size_t N = 0>
-	constexpr auto search_max_in_pos() {
-		constexpr auto Total = member_count<T>();
-		if constexpr (!has_extra_elements<T, pos>()) {
+	// Initializers taken by the member at Position: Flat - Position - R, R being the most Any
+	// that can follow a braced initializer in its place (more than one for a C array only, a
+	// member {Any} can not initialize takes one). The Any after it still have to initialize the
+	// later members that need it, so the valid R are a window as wide as
+	// [first_valid_count, Flat]: probing down from R in steps of that width lands in it, and
+	// bisection below Above, the last failed probe, finds its top.
+	template <typename T, ::std::size_t Flat, ::std::size_t Position, ::std::size_t R, ::std::size_t Above>
+	constexpr ::std::size_t member_width() {
+		constexpr ::std::size_t step = Flat - first_valid_count<T>() + 1;
+		if constexpr (test_braced<T, Position, R>()) {
+			constexpr auto valid = []<::std::size_t N>() { return test_braced<T, Position, N>(); };
+			return Flat - Position - bisect_count<R, Above>(valid);
+		}
+		else if constexpr (R == 0) {
 			return 1;
 		}
 		else {
-			::std::size_t result = 0;
-			[&] <::std::size_t... Is>(::std::index_sequence<Is...>) {
-				((try_place_n_in_pos<T, pos, Is>() ? result = Is : 0), ...);
-			}(::std::make_index_sequence<Total + 1>());
-			return result;
+			return member_width<T, Flat, Position, (R > step ? R - step : 0), R>();
 		}
 	}
 
-	template<typename T, ::std::size_t N = 0>
-	constexpr auto search_all_extra_index(auto&& array) {
-		constexpr auto total = member_count<T>();
-		constexpr auto num = search_max_in_pos<T, N>();
-		constexpr auto value = num > 1 ? num : 1;
-		array[N] = value;
-		if constexpr (N + value < total) {
-			search_all_extra_index<T, N + value>(array);
+	// initializers taken by the members from the one starting at Position on, walking
+	// member by member
+	template <typename T, ::std::size_t Flat, ::std::size_t Position = 0>
+	constexpr ::std::size_t count_members_from() {
+		if constexpr (Position >= Flat) {
+			return 0;
+		}
+		else {
+			constexpr ::std::size_t taken = member_width<T, Flat, Position, Flat - Position - 1, Flat - Position>();
+			return 1 + count_members_from<T, Flat, Position + taken>();
 		}
 	}
 
 	template<typename T>
-	constexpr auto true_member_count() {
-		constexpr auto Total = member_count<T>();
-		if constexpr (Total == 0) {
-			return 0;
+	constexpr ::std::size_t member_count() {
+		constexpr auto valid = []<::std::size_t N>() { return test<T, N>(); };
+		constexpr ::std::size_t flat = gallop_count<first_valid_count<T>()>(valid);
+		// one braced initializer per member: no C array was split, flat is the member count
+		if constexpr (test_all_braced<T, flat>()) {
+			return flat;
 		}
 		else {
-			::std::array<::std::size_t, Total> indices = { 1 };
-			search_all_extra_index<T>(indices);
-			::std::size_t result = Total;
-			::std::size_t index = 0;
-			while (index < Total) {
-				auto n = indices[index];
-				result -= n - 1;
-				index += n;
-			}
-			return result;
+			return count_members_from<T, flat>();
 		}
 	}
 
+	template<typename T>
+	constexpr ::std::size_t true_member_count() {
+		return member_count<T>();
+	}
+
 	template <typename T>
 	inline constexpr ::std::size_t members_count_v = true_member_count<remove_cvref_t<T>>();
 
@@ -140,33 +157,42 @@ namespace tinyrefl::detail {
 	template <typename T>
 	concept AggregateType = ::std::is_aggregate_v<remove_cvref_t<T>>;
 
+#if defined(__cpp_structured_bindings) && __cpp_structured_bindings >= 202411L
+	// structured binding packs (C++26): one definition for every member count
 	template <AggregateType T, size_t N>
 	struct get_member_references_tuple {
-		// get tuple by type
+		static_assert(N > 0, "Too few structural member parameters (size <= 0)");
+
 		inline static constexpr auto get_tuple() {
-			if constexpr (N <= 0) {
-				static_assert(N <= 0, "Too few structural member parameters (size <= 0)");
-			}
-			else {
-				static_assert(N > 5, "Too many structural member parameters (size >= 5)");
-			}
+			auto& [... members] = external_value<T>.value;
+			return ::std::tie(members...);
 		}
 
-		inline static auto get_reference_value(T&& t) {
-			if constexpr (N <= 0) {
-				static_assert(NULL <= 0, "Too few structural member parameters (size <= 0)");
-			}
-			else {
-				static_assert(N > 5, "Too many structural member parameters (size >= 5)");
-			}
+		inline static decltype(auto) get_reference_value(T&& t) {
+			auto&& [... members] = ::std::forward<T>(t);
+			return ::std::tie(members...);
 		}
 	};
+#else
+	// Up to 64 members are always available. Each further chunk of 64 specializations is
+	// only preprocessed when TINYREFL_MAX_MEMBER_COUNT asks for it, so wide structs don't
+	// cost every includer: define it (up to 256) before including tinyrefl.
+#ifndef TINYREFL_MAX_MEMBER_COUNT
+#define TINYREFL_MAX_MEMBER_COUNT 64
+#endif
+
+	template <AggregateType T, size_t N>
+	struct get_member_references_tuple {
+		static_assert(N > 0, "Too few structural member parameters (size <= 0)");
+		static_assert(N == 0 || N > 256, "Too many structural member parameters, raise TINYREFL_MAX_MEMBER_COUNT");
+		static_assert(N <= 256, "Too many structural member parameters (size > 256)");
+	};
 
 #define GET_MEMBER_TUPLE_HELPER(n, ...) 						\
 template <AggregateType T>   									\
 struct get_member_references_tuple<T, n> { 						\
 	inline static constexpr auto get_tuple() {  	   			\
-		auto& [__VA_ARGS__] = Wrapper<T>::value;			    \
+		auto& [__VA_ARGS__] = external_value<T>.value;		    \
 		return ::std::tie(__VA_ARGS__);							\
 	}   														\
 	inline static decltype(auto) get_reference_value(T&& t) {   \
@@ -176,19 +202,32 @@ struct get_member_references_tuple<T, n> { 						\
 };															
 
 #include "reflection_get_member_tuple_helper.hpp"
+#if TINYREFL_MAX_MEMBER_COUNT > 64
+#include "reflection_get_member_tuple_helper_128.hpp"
+#endif
+#if TINYREFL_MAX_MEMBER_COUNT > 128
+#include "reflection_get_member_tuple_helper_192.hpp"
+#endif
+#if TINYREFL_MAX_MEMBER_COUNT > 192
+#include "reflection_get_member_tuple_helper_256.hpp"
+#endif
+
+#undef GET_MEMBER_TUPLE_HELPER
+#endif
 
 	template <AggregateType T>
 	using member_array = ::std::array<::std::string_view, members_count_v<remove_cvref_t<T>>>;
 
-	// get members tuple
+	// get members tuple, references into external_value<T>: for constant expressions only
 	template  <AggregateType T>
 	inline constexpr auto struct_members_to_tuple() {
 		return get_member_references_tuple<T, members_count_v<T>>::get_tuple();
 	}
 
-	// get members array
+	// member names as slices of the __PRETTY_FUNCTION__ signatures: compile time only, copied
+	// into member_name_table so the long signatures are never kept in the binary
 	template <AggregateType T>
-	inline consteval member_array<T> struct_members_to_array() {
+	inline consteval member_array<T> struct_member_signature_names() {
 		using U = remove_cvref_t<T>;
 		constexpr auto tuple = struct_members_to_tuple<U>();
 		return[&] <size_t... Is>(::std::index_sequence<Is...>) {
@@ -196,6 +235,55 @@ struct get_member_references_tuple<T, n> { 						\
 		}(::std::make_index_sequence<members_count_v<U>>());
 	}
 
+	template <AggregateType T>
+	inline consteval ::std::size_t member_names_length() {
+		::std::size_t length = 0;
+		for (auto name : struct_member_signature_names<T>()) {
+			length += name.size() + 1;
+		}
+		return length;
+	}
+
+	// all member names of T in one blob, each ended by '\0', name i at offsets[i]
+	template <AggregateType T>
+	struct member_name_table {
+		static constexpr ::std::size_t count = members_count_v<T>;
+
+		static constexpr ::std::array<char, member_names_length<T>()> blob = [] {
+			::std::array<char, member_names_length<T>()> chars{};
+			::std::size_t pos = 0;
+			for (auto name : struct_member_signature_names<T>()) {
+				for (char c : name) {
+					chars[pos++] = c;
+				}
+				chars[pos++] = '\0';
+			}
+			return chars;
+		}();
+
+		static constexpr ::std::array<::std::size_t, count + 1> offsets = [] {
+			::std::array<::std::size_t, count + 1> starts{};
+			for (::std::size_t i = 0, pos = 0; i <= count; ++i) {
+				starts[i] = pos;
+				while (i < count && blob[pos++] != '\0') {}
+			}
+			return starts;
+		}();
+
+		static constexpr ::std::string_view name(::std::size_t i) {
+			return ::std::string_view(blob.data() + offsets[i], offsets[i + 1] - offsets[i] - 1);
+		}
+	};
+
+	// get members array, views into member_name_table<T>::blob
+	template <AggregateType T>
+	inline consteval member_array<T> struct_members_to_array() {
+		using Table = member_name_table<remove_cvref_t<T>>;
+		return[] <size_t... Is>(::std::index_sequence<Is...>) {
+			return member_array<T>{Table::name(Is)...};
+		}(::std::make_index_sequence<Table::count>());
+	}
+
 	// get members reference
 	template <size_t Index, typename T>
 	inline decltype(auto) struct_member_reference(T&& t) {
@@ -205,21 +293,48 @@ struct get_member_references_tuple<T, n> { 						\
 		return ::std::get<Index>(get_member_references_tuple<T, count>::get_reference_value(::std::forward<T>(t)));
 	}
 
+	// tuple of references to the members of T, named without any T object
+	template <AggregateType T>
+	using struct_members_tuple_t = decltype(get_member_references_tuple<remove_cvref_t<T>&, members_count_v<T>>::get_reference_value(
+		::std::declval<remove_cvref_t<T>&>()));
+
+	// Storage for the T whose member addresses give the offsets: the members are only bound
+	// by reference, never read or written. A default constructible T is constructed, so the
+	// addresses are those of a live object. Any other T stays an inactive union member, and
+	// binding its members is formally undefined behaviour, which GCC, Clang and MSVC compile
+	// to the member addresses of a live T.
+	template <typename T>
+	union member_address_probe {
+		char none;
+		T value;
+
+		member_address_probe() : none() {
+			if constexpr (::std::is_default_constructible_v<T>) {
+				::std::construct_at(::std::addressof(value));
+			}
+		}
+		~member_address_probe() {
+			if constexpr (::std::is_default_constructible_v<T>) {
+				value.~T();
+			}
+		}
+	};
+
 	// get members offset array
+	// Taken from the member addresses: alignas, packing and [[no_unique_address]] move members
+	// away from where their types alone would put them. Member addresses are not constant
+	// expressions, so the array is filled on first use, behind the init guard of a local static.
 	template <AggregateType T>
 	inline const auto& struct_member_offset_array() {
-		using offset_v = ::std::size_t;
-		using member_offset_array_t = ::std::array<offset_v, members_count_v<T>>;
-
-		constexpr ::std::size_t members_count = members_count_v<T>;
-		constexpr auto members_tuple = struct_members_to_tuple<T>();
-		static member_offset_array_t offset_array = { [&] <size_t... Is>(::std::index_sequence<Is...>) mutable -> member_offset_array_t {
-			member_offset_array_t arr;
-			T dummy{};
-			auto tie = get_member_references_tuple<T, members_count>::get_reference_value(::std::move(dummy));
-			((arr[Is] = offset_v(reinterpret_cast<uint8_t*>(&::std::get<Is>(tie)) - reinterpret_cast<uint8_t*>(&dummy))), ...);
-			return arr;
-		}(::std::make_index_sequence<members_count>{}) };
+		using U = remove_cvref_t<T>;
+		using member_offset_array_t = ::std::array<::std::size_t, members_count_v<U>>;
+
+		static const member_offset_array_t offset_array = [] <size_t... Is>(::std::index_sequence<Is...>) {
+			member_address_probe<U> probe;
+			auto tie = get_member_references_tuple<U&, members_count_v<U>>::get_reference_value(probe.value);
+			const auto* base = reinterpret_cast<const unsigned char*>(::std::addressof(probe.value));
+			return member_offset_array_t{ ::std::size_t(reinterpret_cast<const unsigned char*>(::std::addressof(::std::get<Is>(tie))) - base)... };
+		}(::std::make_index_sequence<members_count_v<U>>{});
 
 		return offset_array;
 	}
@@ -327,4 +442,26 @@ struct get_member_references_tuple<T, n> { 						\
 		return get_variant_map_filtered_impl<U>(serializable_indices_t<U>{});
 	}
 
+	// get variant table filtered impl, position i matches member_key_index_v<T> position i
+	template <typename T, ::std::size_t... Is>
+	inline auto get_variant_table_filtered_impl(::std::index_sequence<Is...>) {
+		using U = remove_cvref_t<T>;
+		auto& member_offset_arr = struct_member_offset_array<U>();
+		using Tuple = struct_members_tuple_t<U>;
+		using ValueType = decltype(get_variant_type<U, Tuple, Is...>());
+
+		return ::std::array<ValueType, sizeof...(Is)>{
+			ValueType{ ::std::in_place_index<index_in_pack<Is, Is...>()>,
+				offset_of_member<remove_cvref_t<::std::tuple_element_t<Is, Tuple>>>{member_offset_arr[Is]} }...
+		};
+	}
+
+	// get struct member offset table, built on first use from the offsets
+	template <typename T>
+	inline const auto& struct_member_offset_table() {
+		using U = remove_cvref_t<T>;
+		static const auto table = get_variant_table_filtered_impl<U>(serializable_indices_t<U>{});
+		return table;
+	}
+
 }
\ No newline at end of file
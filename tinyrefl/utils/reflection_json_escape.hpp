@@ -0,0 +1,137 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TINYREFL_JSON_ESCAPE_SSE2
+#endif
+
+namespace tinyrefl::detail {
+
+	// 0: copy as is, 'u': \u00XX, other: two char escape \x
+	inline constexpr char json_escape_table[256] = {
+		'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+		'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+		0, 0, '"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0,
+	};
+
+	// find the first byte that needs escaping ('"', '\\', < 0x20), last if none
+	inline const char* find_json_escape(const char* first, const char* last) {
+#if defined(__AVX2__)
+		const __m256i quote = _mm256_set1_epi8('"');
+		const __m256i backslash = _mm256_set1_epi8('\\');
+		const __m256i control = _mm256_set1_epi8(0x1F);
+		for (; last - first >= 32; first += 32) {
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+			const __m256i hit = _mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)),
+				_mm256_cmpeq_epi8(_mm256_max_epu8(v, control), control));
+			const auto mask = static_cast<::std::uint32_t>(_mm256_movemask_epi8(hit));
+			if (mask != 0) {
+				return first + ::std::countr_zero(mask);
+			}
+		}
+#elif defined(TINYREFL_JSON_ESCAPE_SSE2)
+		const __m128i quote = _mm_set1_epi8('"');
+		const __m128i backslash = _mm_set1_epi8('\\');
+		const __m128i control = _mm_set1_epi8(0x1F);
+		for (; last - first >= 16; first += 16) {
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+			const __m128i hit = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+				_mm_cmpeq_epi8(_mm_max_epu8(v, control), control));
+			const auto mask = static_cast<::std::uint32_t>(_mm_movemask_epi8(hit));
+			if (mask != 0) {
+				return first + ::std::countr_zero(mask);
+			}
+		}
+#endif
+		for (; first != last; ++first) {
+			if (json_escape_table[static_cast<unsigned char>(*first)]) {
+				return first;
+			}
+		}
+		return last;
+	}
+
+	// write the escape sequence of one byte, return its length (2 or 6)
+	inline ::std::size_t write_json_escape(char* buffer, char c) {
+		const char escape = json_escape_table[static_cast<unsigned char>(c)];
+		buffer[0] = '\\';
+		if (escape != 'u') {
+			buffer[1] = escape;
+			return 2;
+		}
+		constexpr char hex[] = "0123456789ABCDEF";
+		::std::memcpy(buffer + 1, "u00", 3);
+		buffer[4] = hex[(static_cast<unsigned char>(c) >> 4) & 0xF];
+		buffer[5] = hex[static_cast<unsigned char>(c) & 0xF];
+		return 6;
+	}
+
+	// length of the quoted, escaped json string
+	inline ::std::size_t json_string_size(const char* str, ::std::size_t length) {
+		const char* last = str + length;
+		::std::size_t size = length + 2;
+		for (;;) {
+			const char* next = find_json_escape(str, last);
+			if (next == last) {
+				return size;
+			}
+			size += json_escape_table[static_cast<unsigned char>(*next)] == 'u' ? 5 : 1;
+			str = next + 1;
+		}
+	}
+
+	// worst case of the quoted, escaped json string (every byte as \u00XX)
+	inline constexpr ::std::size_t json_string_max_size(::std::size_t length) {
+		return length * 6 + 2;
+	}
+
+	// write the quoted, escaped json string into buffer (json_string_max_size bytes), return the end pointer
+	inline char* write_json_string(char* buffer, const char* str, ::std::size_t length) {
+		const char* last = str + length;
+		*buffer++ = '"';
+		for (;;) {
+			const char* next = find_json_escape(str, last);
+			::std::memcpy(buffer, str, static_cast<::std::size_t>(next - str));
+			buffer += next - str;
+			if (next == last) {
+				break;
+			}
+			buffer += write_json_escape(buffer, *next);
+			str = next + 1;
+		}
+		*buffer++ = '"';
+		return buffer;
+	}
+
+	// quoted, escaped json string; clean runs are copied in bulk
+	template <typename Stream>
+	inline void write_json_string(Stream& s, const char* str, ::std::size_t length) {
+		const char* last = str + length;
+		s.append("\"", 1);
+		for (;;) {
+			const char* next = find_json_escape(str, last);
+			if (next != str) {
+				s.append(str, static_cast<::std::size_t>(next - str));
+			}
+			if (next == last) {
+				break;
+			}
+			char buffer[6];
+			s.append(buffer, write_json_escape(buffer, *next));
+			str = next + 1;
+		}
+		s.append("\"", 1);
+	}
+
+}  // end namespace tinyrefl::detail
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <limits>
+
+#include "reflection_utils.hpp"
+#include "../thirdparty/rapidjson/internal/itoa.h"
+
+namespace tinyrefl::detail {
+
+	// longest json number text: "-2.2250738585072014e-308" for double, 20 digits + sign for int64
+	inline constexpr ::std::size_t json_number_max_length = 32;
+
+	// write a number into buffer without allocation, return the end pointer.
+	// integers use rapidjson's digit-pair tables, floating point uses the shortest
+	// text that round-trips (std::to_chars), NaN and Inf are not json and become null
+	template <typename T>
+	inline char* write_json_number(char* buffer, T value) {
+		using U = remove_cvref_t<T>;
+		if constexpr (is_floating_v<U>) {
+			if (!::std::isfinite(value)) {
+				::std::memcpy(buffer, "null", 4);
+				return buffer + 4;
+			}
+			return ::std::to_chars(buffer, buffer + json_number_max_length, value).ptr;
+		}
+		else if constexpr (::std::is_signed_v<U>) {
+			if constexpr (sizeof(U) <= sizeof(::std::int32_t)) {
+				return ::rapidjson::internal::i32toa(static_cast<::std::int32_t>(value), buffer);
+			}
+			else {
+				return ::rapidjson::internal::i64toa(static_cast<::std::int64_t>(value), buffer);
+			}
+		}
+		else {
+			if constexpr (sizeof(U) <= sizeof(::std::uint32_t)) {
+				return ::rapidjson::internal::u32toa(static_cast<::std::uint32_t>(value), buffer);
+			}
+			else {
+				return ::rapidjson::internal::u64toa(static_cast<::std::uint64_t>(value), buffer);
+			}
+		}
+	}
+
+	// digits of an unsigned value
+	inline ::std::size_t count_decimal_digits(::std::uint64_t value) {
+		::std::size_t digits = 1;
+		for (; value >= 10000; value /= 10000) {
+			digits += 4;
+		}
+		return digits + (value >= 10) + (value >= 100) + (value >= 1000);
+	}
+
+	// exact length written by write_json_number for integers, an upper bound for floating point
+	template <typename T>
+	inline ::std::size_t json_number_size(T value) {
+		using U = remove_cvref_t<T>;
+		if constexpr (is_floating_v<U>) {
+			// sign, digits, '.', 'e', exponent sign and digits
+			constexpr ::std::size_t exponent_digits = ::std::numeric_limits<U>::max_exponent10 >= 1000 ? 4
+				: ::std::numeric_limits<U>::max_exponent10 >= 100 ? 3 : 2;
+			return ::std::numeric_limits<U>::max_digits10 + 4 + exponent_digits;
+		}
+		else if constexpr (::std::is_signed_v<U>) {
+			const auto magnitude = value < 0 ? 0 - static_cast<::std::uint64_t>(value) : static_cast<::std::uint64_t>(value);
+			return count_decimal_digits(magnitude) + (value < 0);
+		}
+		else {
+			return count_decimal_digits(static_cast<::std::uint64_t>(value));
+		}
+	}
+
+	// bit 7 of every byte of a little endian word that is not '0'..'9'
+	inline constexpr ::std::uint64_t non_digit_bytes(::std::uint64_t word) {
+		const ::std::uint64_t t = word ^ 0x3030303030303030;
+		return (((t & 0x7F7F7F7F7F7F7F7F) + 0x7676767676767676) | t) & 0x8080808080808080;
+	}
+
+	// value of 8 ascii digits, the first one in the lowest byte
+	inline constexpr ::std::uint64_t parse_eight_digits(::std::uint64_t word) {
+		word -= 0x3030303030303030;
+		word = word * 10 + (word >> 8);
+		return ((word & 0x000000FF000000FF) * 0x000F424000000064 +
+			((word >> 16) & 0x000000FF000000FF) * 0x0000271000000001) >> 32;
+	}
+
+	inline constexpr ::std::uint64_t json_pow10_u64[9] = {
+		1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+	};
+
+	// append the digit run at first to value, 8 digits per step; the end of the run.
+	// value wraps past 19 digits, callers check the length
+	inline const char* parse_json_digits(const char* first, const char* last, ::std::uint64_t& value) {
+		if constexpr (::std::endian::native == ::std::endian::little) {
+			while (last - first >= 8) {
+				::std::uint64_t word;
+				::std::memcpy(&word, first, 8);
+				const ::std::uint64_t non_digit = non_digit_bytes(word);
+				if (non_digit == 0) {
+					value = value * 100000000 + parse_eight_digits(word);
+					first += 8;
+					continue;
+				}
+				const int n = ::std::countr_zero(non_digit) / 8;
+				if (n != 0) {
+					// right align the n digits and pad the front with '0'
+					const int shift = 8 * (8 - n);
+					word = (word << shift) | (::std::uint64_t(0x3030303030303030) >> (64 - shift));
+					value = value * json_pow10_u64[n] + parse_eight_digits(word);
+				}
+				return first + n;
+			}
+		}
+		for (; first != last && *first >= '0' && *first <= '9'; ++first) {
+			value = value * 10 + static_cast<unsigned>(*first - '0');
+		}
+		return first;
+	}
+
+	// the integer of the given sign and magnitude is representable in the integer type T
+	template <typename T>
+	inline constexpr bool json_integer_fits(bool minus, ::std::uint64_t magnitude) {
+		using Limits = ::std::numeric_limits<T>;
+		if (!minus) {
+			return magnitude <= static_cast<::std::uint64_t>(Limits::max());
+		}
+		if constexpr (Limits::is_signed) {
+			return magnitude <= static_cast<::std::uint64_t>(Limits::max()) + 1;
+		}
+		return magnitude == 0;
+	}
+
+	// static_cast<T>(d) is defined: d is in the range of a floating point T, or its
+	// integral part is in the range of an integer T
+	template <typename T>
+	inline bool json_double_fits(double d) {
+		using Limits = ::std::numeric_limits<T>;
+		if constexpr (is_floating_v<T>) {
+			return sizeof(T) >= sizeof(double) || ::std::fabs(d) <= static_cast<double>(Limits::max());
+		}
+		else {
+			// 2^digits, exact in a double
+			constexpr double upper = static_cast<double>(Limits::max() / 2 + 1) * 2.0;
+			const double integral = ::std::trunc(d);
+			return integral < upper && integral >= (Limits::is_signed ? -upper : 0.0);
+		}
+	}
+
+	// Number at first, converted the way JsonReader::read_number does, straight from the
+	// buffer. nullptr when the text is something else or needs the general path: a grammar
+	// error, more than 19 digits, an out of range double, a fraction for an integer target,
+	// a value T can not hold.
+	template <typename T>
+	inline const char* parse_json_number_fast(const char* first, const char* last, T& value) {
+		static constexpr double pow10[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+		};
+
+		const char* p = first;
+		const bool minus = p != last && *p == '-';
+		p += minus;
+		const char* integer = p;
+		::std::uint64_t mantissa = 0;
+		p = parse_json_digits(p, last, mantissa);
+		::std::ptrdiff_t digits = p - integer;
+		if (digits == 0 || (*integer == '0' && digits > 1)) {
+			return nullptr;
+		}
+
+		::std::ptrdiff_t fraction = 0;
+		::std::int64_t exponent = 0;
+		const bool fractional = p != last && *p == '.';
+		if (fractional) {
+			const char* fraction_first = ++p;
+			p = parse_json_digits(p, last, mantissa);
+			fraction = p - fraction_first;
+			if (fraction == 0) {
+				return nullptr;
+			}
+			digits += fraction;
+			if (*integer == '0') {
+				// leading zeros of 0.000ddd do not count against the 19 digit mantissa
+				const char* q = fraction_first;
+				for (--digits; q != p && *q == '0'; ++q) {
+					--digits;
+				}
+			}
+		}
+		const bool scientific = p != last && (*p == 'e' || *p == 'E');
+		if (scientific) {
+			++p;
+			const bool negative_exponent = p != last && *p == '-';
+			p += (p != last && (*p == '+' || *p == '-'));
+			const char* exponent_first = p;
+			for (; p != last && *p >= '0' && *p <= '9'; ++p) {
+				exponent = ::std::min<::std::int64_t>(exponent * 10 + (*p - '0'), 100000);
+			}
+			if (p == exponent_first) {
+				return nullptr;
+			}
+			exponent = negative_exponent ? -exponent : exponent;
+		}
+		if (digits > 19) {
+			return nullptr;
+		}
+
+		if (!fractional && !scientific) {
+			if constexpr (!is_floating_v<T>) {
+				if (!json_integer_fits<T>(minus, mantissa)) {
+					return nullptr;
+				}
+			}
+			if (!minus) {
+				value = static_cast<T>(mantissa);
+			}
+			else if (mantissa <= ::std::uint64_t(INT64_MAX) + 1) {
+				value = static_cast<T>(static_cast<::std::int64_t>(0 - mantissa));
+			}
+			else {
+				return nullptr;
+			}
+			return p;
+		}
+		if constexpr (!is_floating_v<T>) {
+			return nullptr;
+		}
+		else {
+			const ::std::int64_t scale = exponent - fraction;
+			if (mantissa <= (::std::uint64_t(1) << 53) && scale >= -22 && scale <= 22) {
+				// exact operands give the correctly rounded quotient/product
+				double d = static_cast<double>(mantissa);
+				d = scale < 0 ? d / pow10[-scale] : d * pow10[scale];
+				value = static_cast<T>(minus ? -d : d);
+				return p;
+			}
+			if constexpr (::std::numeric_limits<long double>::digits == 64) {
+				// x87 extended precision holds 19 digit mantissas and 10^27 exactly. Rounding the
+				// exact result to 64 bits cannot cross a double midpoint, only land on one:
+				// unless it did, rounding that to double is the correctly rounded value
+				static constexpr long double pow10_extended[] = {
+					1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L, 1e12L, 1e13L,
+					1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L,
+					1e26L, 1e27L,
+				};
+				if (scale >= -27 && scale <= 27) {
+					long double extended = static_cast<long double>(mantissa);
+					extended = scale < 0 ? extended / pow10_extended[-scale] : extended * pow10_extended[scale];
+					::std::uint64_t significand;
+					::std::memcpy(&significand, &extended, sizeof(significand));
+					if ((significand & 0x7FF) != 0x400) {
+						const double d = static_cast<double>(extended);
+						if (!json_double_fits<T>(d)) {
+							return nullptr;
+						}
+						value = static_cast<T>(minus ? -d : d);
+						return p;
+					}
+				}
+			}
+			double d;
+			const auto result = ::std::from_chars(first, p, d);
+			if (result.ec != ::std::errc() || !json_double_fits<T>(d)) {
+				return nullptr;
+			}
+			value = static_cast<T>(d);
+			return p;
+		}
+	}
+
+}  // end namespace tinyrefl::detail
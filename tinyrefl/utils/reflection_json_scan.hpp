@@ -0,0 +1,345 @@
+#pragma once
+
+#include <string_view>
+
+#include "reflection_json_escape.hpp"
+
+namespace tinyrefl::detail {
+
+	// bit i set for the byte i of a 64 byte block: quotes, backslashes, '{' '[', '}' ']' and commas
+	struct json_block_masks {
+		::std::uint64_t quote;
+		::std::uint64_t backslash;
+		::std::uint64_t open;
+		::std::uint64_t close;
+		::std::uint64_t comma;
+	};
+
+	inline json_block_masks classify_json_block(const char* block) {
+		json_block_masks masks{};
+#if defined(__AVX2__)
+		const __m256i quote = _mm256_set1_epi8('"');
+		const __m256i backslash = _mm256_set1_epi8('\\');
+		// '[' and ']' differ from '{' and '}' only in bit 0x20
+		const __m256i fold = _mm256_set1_epi8(0x20);
+		const __m256i open = _mm256_set1_epi8('{');
+		const __m256i close = _mm256_set1_epi8('}');
+		const __m256i comma = _mm256_set1_epi8(',');
+		for (int i = 0; i < 64; i += 32) {
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+			const __m256i folded = _mm256_or_si256(v, fold);
+			auto bits = [&](__m256i hit) {
+				return ::std::uint64_t(static_cast<::std::uint32_t>(_mm256_movemask_epi8(hit))) << i;
+			};
+			masks.quote |= bits(_mm256_cmpeq_epi8(v, quote));
+			masks.backslash |= bits(_mm256_cmpeq_epi8(v, backslash));
+			masks.open |= bits(_mm256_cmpeq_epi8(folded, open));
+			masks.close |= bits(_mm256_cmpeq_epi8(folded, close));
+			masks.comma |= bits(_mm256_cmpeq_epi8(v, comma));
+		}
+#elif defined(TINYREFL_JSON_ESCAPE_SSE2)
+		const __m128i quote = _mm_set1_epi8('"');
+		const __m128i backslash = _mm_set1_epi8('\\');
+		// '[' and ']' differ from '{' and '}' only in bit 0x20
+		const __m128i fold = _mm_set1_epi8(0x20);
+		const __m128i open = _mm_set1_epi8('{');
+		const __m128i close = _mm_set1_epi8('}');
+		const __m128i comma = _mm_set1_epi8(',');
+		for (int i = 0; i < 64; i += 16) {
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+			const __m128i folded = _mm_or_si128(v, fold);
+			auto bits = [&](__m128i hit) {
+				return ::std::uint64_t(static_cast<::std::uint32_t>(_mm_movemask_epi8(hit))) << i;
+			};
+			masks.quote |= bits(_mm_cmpeq_epi8(v, quote));
+			masks.backslash |= bits(_mm_cmpeq_epi8(v, backslash));
+			masks.open |= bits(_mm_cmpeq_epi8(folded, open));
+			masks.close |= bits(_mm_cmpeq_epi8(folded, close));
+			masks.comma |= bits(_mm_cmpeq_epi8(v, comma));
+		}
+#else
+		for (int i = 0; i < 64; ++i) {
+			const char c = block[i];
+			const char folded = static_cast<char>(c | 0x20);
+			masks.quote |= ::std::uint64_t(c == '"') << i;
+			masks.backslash |= ::std::uint64_t(c == '\\') << i;
+			masks.open |= ::std::uint64_t(folded == '{') << i;
+			masks.close |= ::std::uint64_t(folded == '}') << i;
+			masks.comma |= ::std::uint64_t(c == ',') << i;
+		}
+#endif
+		return masks;
+	}
+
+	// bit i = xor of bits 0..i
+	inline constexpr ::std::uint64_t prefix_xor(::std::uint64_t x) {
+		x ^= x << 1;
+		x ^= x << 2;
+		x ^= x << 4;
+		x ^= x << 8;
+		x ^= x << 16;
+		x ^= x << 32;
+		return x;
+	}
+
+	// first '\n' in [first, last), last if none. json strings cannot hold a raw newline,
+	// so every one found ends a line of newline delimited json
+	inline const char* find_newline(const char* first, const char* last) {
+#if defined(__AVX2__)
+		const __m256i newline = _mm256_set1_epi8('\n');
+		for (; last - first >= 32; first += 32) {
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+			const auto mask = static_cast<::std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, newline)));
+			if (mask != 0) {
+				return first + ::std::countr_zero(mask);
+			}
+		}
+#elif defined(TINYREFL_JSON_ESCAPE_SSE2)
+		const __m128i newline = _mm_set1_epi8('\n');
+		for (; last - first >= 16; first += 16) {
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+			const auto mask = static_cast<::std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline)));
+			if (mask != 0) {
+				return first + ::std::countr_zero(mask);
+			}
+		}
+#endif
+		for (; first != last && *first != '\n'; ++first) {
+		}
+		return first;
+	}
+
+	// end of the json string whose opening quote is at first, nullptr if it is unterminated
+	inline const char* scan_json_string(const char* first, const char* last) {
+		for (++first;;) {
+			first = find_json_escape(first, last);
+			if (first == last) {
+				return nullptr;
+			}
+			if (*first == '"') {
+				return first + 1;
+			}
+			if (*first != '\\' || last - first < 2) {
+				// raw control byte or a dangling backslash
+				return nullptr;
+			}
+			switch (first[1]) {
+			case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+				first += 2;
+				break;
+			case 'u':
+				if (last - first < 6) {
+					return nullptr;
+				}
+				for (int i = 2; i < 6; ++i) {
+					const char c = static_cast<char>(first[i] | 0x20);
+					if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+						return nullptr;
+					}
+				}
+				first += 6;
+				break;
+			default:
+				return nullptr;
+			}
+		}
+	}
+
+	// Walks a buffer 64 bytes at a time and yields the bracket and comma masks outside of strings.
+	// Escaped quotes are masked out, and the string interior is the prefix xor of the remaining quotes.
+	class json_block_scanner {
+	public:
+		json_block_scanner(const char* first, const char* last) : _block(first), _last(last) {}
+
+		bool done() const { return _block >= _last; }
+		const char* block() const { return _block; }
+		void next() { _block += 64; }
+
+		// masks of the current block with string contents cleared
+		json_block_masks classify() {
+			const char* bytes = _block;
+			if (_last - _block < 64) {
+				::std::memset(_tail, ' ', sizeof(_tail));
+				::std::memcpy(_tail, _block, static_cast<::std::size_t>(_last - _block));
+				bytes = _tail;
+			}
+			json_block_masks masks = classify_json_block(bytes);
+
+			// a backslash escapes the next byte unless it is escaped itself
+			::std::uint64_t escaped = _escape_carry;
+			_escape_carry = 0;
+			for (::std::uint64_t backslash = masks.backslash & ~escaped; backslash != 0;) {
+				const int i = ::std::countr_zero(backslash);
+				if (i == 63) {
+					_escape_carry = 1;
+					break;
+				}
+				escaped |= ::std::uint64_t(1) << (i + 1);
+				backslash &= ~((::std::uint64_t(2) << i) - 1) & ~escaped;
+			}
+
+			const ::std::uint64_t in_string = prefix_xor(masks.quote & ~escaped) ^ _string_carry;
+			_string_carry = ::std::uint64_t(0) - (in_string >> 63);
+			masks.open &= ~in_string;
+			masks.close &= ~in_string;
+			masks.comma &= ~in_string;
+			return masks;
+		}
+
+	private:
+		const char* _block;
+		const char* _last;
+		::std::uint64_t _escape_carry = 0;   // bit 0: the previous block ended in an unescaped backslash
+		::std::uint64_t _string_carry = 0;   // all ones: the previous block ended inside a string
+		char _tail[64];
+	};
+
+	// number of members/elements of a non-empty object or array, first being just inside it
+	// (its top level commas plus one), 0 if it is unterminated
+	inline ::std::size_t count_json_elements(const char* first, const char* last) {
+		::std::size_t depth = 1;
+		::std::size_t count = 1;
+		for (json_block_scanner scanner(first, last); !scanner.done(); scanner.next()) {
+			const json_block_masks masks = scanner.classify();
+			if ((masks.open | masks.close) == 0) {
+				// flat run, e.g. the numbers of an array
+				count += depth == 1 ? static_cast<::std::size_t>(::std::popcount(masks.comma)) : 0;
+				continue;
+			}
+			for (::std::uint64_t bits = masks.open | masks.close | masks.comma; bits != 0; bits &= bits - 1) {
+				const ::std::uint64_t bit = bits & (0 - bits);
+				if (masks.open & bit) {
+					++depth;
+				}
+				else if (masks.close & bit) {
+					if (--depth == 0) {
+						return count;
+					}
+				}
+				else if (depth == 1) {
+					++count;
+				}
+			}
+		}
+		return 0;
+	}
+
+	inline const char* skip_json_space(const char* first, const char* last) {
+		while (first != last && (*first == ' ' || *first == '\n' || *first == '\r' || *first == '\t')) {
+			++first;
+		}
+		return first;
+	}
+
+	// end of the json number at first, nullptr if it breaks the number grammar.
+	// Only the grammar is checked, the number is not converted.
+	inline const char* scan_json_number(const char* first, const char* last) {
+		auto digits = [&] {
+			const char* begin = first;
+			while (first != last && *first >= '0' && *first <= '9') {
+				++first;
+			}
+			return first != begin;
+		};
+		if (first != last && *first == '-') {
+			++first;
+		}
+		if (first != last && *first == '0') {
+			++first;
+		}
+		else if (!digits()) {
+			return nullptr;
+		}
+		if (first != last && *first == '.') {
+			++first;
+			if (!digits()) {
+				return nullptr;
+			}
+		}
+		if (first != last && (*first == 'e' || *first == 'E')) {
+			++first;
+			if (first != last && (*first == '+' || *first == '-')) {
+				++first;
+			}
+			if (!digits()) {
+				return nullptr;
+			}
+		}
+		return first;
+	}
+
+	// end of literal at first, nullptr if the bytes differ
+	inline const char* scan_json_literal(const char* first, const char* last, ::std::string_view literal) {
+		if (static_cast<::std::size_t>(last - first) < literal.size() ||
+			::std::memcmp(first, literal.data(), literal.size()) != 0) {
+			return nullptr;
+		}
+		return first + literal.size();
+	}
+
+	inline const char* scan_json_value(const char* first, const char* last);
+
+	// one element of an object (key, ':' and value) or of an array, leading whitespace included
+	inline const char* scan_json_element(const char* first, const char* last, char close) {
+		first = skip_json_space(first, last);
+		if (close == '}') {
+			if (first == last || *first != '"' || (first = scan_json_string(first, last)) == nullptr) {
+				return nullptr;
+			}
+			first = skip_json_space(first, last);
+			if (first == last || *first != ':') {
+				return nullptr;
+			}
+			first = skip_json_space(first + 1, last);
+		}
+		return scan_json_value(first, last);
+	}
+
+	// just past the close bracket, first being after an element of the object or array
+	inline const char* scan_json_rest(const char* first, const char* last, char close) {
+		for (;;) {
+			first = skip_json_space(first, last);
+			if (first == last) {
+				return nullptr;
+			}
+			if (*first == close) {
+				return first + 1;
+			}
+			if (*first != ',' || (first = scan_json_element(first + 1, last, close)) == nullptr) {
+				return nullptr;
+			}
+		}
+	}
+
+	// End of the json value starting at first, nullptr if it is malformed or unterminated.
+	// The grammar is checked without decoding anything: strings go through the escape kernel,
+	// numbers are not converted.
+	inline const char* scan_json_value(const char* first, const char* last) {
+		if (first == last) {
+			return nullptr;
+		}
+		switch (*first) {
+		case '"':
+			return scan_json_string(first, last);
+		case '{':
+		case '[': {
+			const char close = *first == '{' ? '}' : ']';
+			first = skip_json_space(first + 1, last);
+			if (first != last && *first == close) {
+				return first + 1;
+			}
+			first = scan_json_element(first, last, close);
+			return first == nullptr ? nullptr : scan_json_rest(first, last, close);
+		}
+		case 't':
+			return scan_json_literal(first, last, "true");
+		case 'f':
+			return scan_json_literal(first, last, "false");
+		case 'n':
+			return scan_json_literal(first, last, "null");
+		default:
+			return scan_json_number(first, last);
+		}
+	}
+
+}  // end namespace tinyrefl::detail
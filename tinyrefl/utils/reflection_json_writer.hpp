@@ -0,0 +1,163 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <concepts>
+#include <algorithm>
+#include <span>
+#include <string_view>
+
+#if __has_include(<sys/uio.h>)
+#include <cerrno>
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#define TINYREFL_HAS_WRITEV
+#endif
+
+namespace tinyrefl {
+
+	// Unchecked bulk writer over a std::string sink.
+	// Callers prepare() a worst-case chunk, write through the raw pointer and commit() the
+	// end once, so tokens skip std::string's per-append capacity check and size update.
+	// The string holds uninitialized slack while writing; flush() (or the destructor) trims it.
+	class json_writer {
+	public:
+		explicit json_writer(::std::string& out) : _out(out), _size(out.size()), _start(out.size()) {}
+		~json_writer() { flush(); }
+
+		json_writer(const json_writer&) = delete;
+		json_writer& operator=(const json_writer&) = delete;
+
+	public:
+		// room for at least length bytes past the committed size
+		char* prepare(::std::size_t length) {
+			if (_out.size() - _size < length) {
+				grow(length);
+			}
+			return _out.data() + _size;
+		}
+
+		// end of the bytes written into the last prepare()d chunk
+		void commit(char* end) { _size = static_cast<::std::size_t>(end - _out.data()); }
+
+		void flush() { _out.resize(_size); }
+
+	public:
+		// OutputStream interface
+		void append(const char* str, ::std::size_t length) {
+			char* p = prepare(length);
+			::std::memcpy(p, str, length);
+			_size += length;
+		}
+
+		void append(const char* str) { append(str, ::std::strlen(str)); }
+
+		void push_back(char c) {
+			*prepare(1) = c;
+			++_size;
+		}
+
+		void reserve(::std::size_t capacity) {
+			if (capacity > _size) {
+				prepare(capacity - _size);
+			}
+		}
+
+		::std::size_t size() const { return _size; }
+
+	private:
+		void grow(::std::size_t length) {
+			// slack grows with what this writer wrote, not with what the string already held, and
+			// stops at max_slack: std::string's own capacity growth keeps appends amortized, the
+			// slack only saves resize() calls. A request beyond max_slack (a long string) gets
+			// max_slack more, so the bytes after it don't regrow the string to twice its size
+			constexpr ::std::size_t max_slack = 64 * 1024;
+			const ::std::size_t written = _out.size() - _start;
+			const ::std::size_t slack = length > max_slack ? length + max_slack
+				: ::std::max({ length, ::std::min(2 * written, max_slack), ::std::size_t(64) });
+#if defined(__cpp_lib_string_resize_and_overwrite)
+			// no zero fill, the slack is written through prepare() before it is committed
+			_out.resize_and_overwrite(_size + slack, [](char*, ::std::size_t size) { return size; });
+#else
+			_out.resize(_size + slack);
+#endif
+		}
+
+	private:
+		::std::string& _out;
+		::std::size_t _size;
+		::std::size_t _start;
+	};
+
+#if defined(TINYREFL_HAS_WRITEV)
+	// Gather sink over a POSIX file descriptor: the buffers handed to write() go out with
+	// writev(2) straight from where they are, without being copied into one block first.
+	// The descriptor is not owned. good() turns false on the first failed write.
+	class fd_writer {
+	public:
+		explicit fd_writer(int fd) : _fd(fd) {}
+
+	public:
+		void write(::std::span<const ::std::string_view> parts) {
+			::std::vector<::iovec> iov;
+			iov.reserve(parts.size());
+			for (::std::string_view part : parts) {
+				if (!part.empty()) {
+					iov.push_back({const_cast<char*>(part.data()), part.size()});
+				}
+			}
+			::iovec* first = iov.data();
+			::iovec* last = first + iov.size();
+			while (_good && first != last) {
+				const int count = static_cast<int>(::std::min<::std::ptrdiff_t>(last - first, IOV_MAX));
+				const ::ssize_t written = ::writev(_fd, first, count);
+				if (written < 0) {
+					_good = errno == EINTR;
+					continue;
+				}
+				_written += static_cast<::std::size_t>(written);
+				// drop the buffers written in full, then the written head of a partial one
+				for (auto left = static_cast<::std::size_t>(written); left != 0;) {
+					if (left >= first->iov_len) {
+						left -= first->iov_len;
+						++first;
+					}
+					else {
+						first->iov_base = static_cast<char*>(first->iov_base) + left;
+						first->iov_len -= left;
+						left = 0;
+					}
+				}
+			}
+		}
+
+		bool good() const { return _good; }
+		::std::size_t written() const { return _written; }
+
+	private:
+		int _fd;
+		bool _good = true;
+		::std::size_t _written = 0;
+	};
+#endif
+
+}  // end namespace tinyrefl
+
+namespace tinyrefl::detail {
+
+	// sink that takes a list of buffers at once, e.g. fd_writer
+	template <typename Stream>
+	concept GatherOutputStream = requires(Stream& s, ::std::span<const ::std::string_view> parts) {
+		s.write(parts);
+	};
+
+	// stream that can be written through a raw pointer
+	template <typename Stream>
+	concept RawOutputStream = requires(Stream& s, char* p) {
+		{ s.prepare(::std::size_t(1)) } -> ::std::same_as<char*>;
+		{ s.commit(p) };
+	};
+
+}  // end namespace tinyrefl::detail
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <bit>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "reflection_get_tuple.hpp"
+
+namespace tinyrefl::detail {
+
+	// hash a key 8 bytes per round, usable both at compile time and on runtime (str, length) slices
+	inline constexpr ::std::uint64_t key_hash_mix(::std::uint64_t h) {
+		h ^= h >> 32;
+		h *= 0xd6e8feb86659fd93ULL;
+		h ^= h >> 32;
+		return h;
+	}
+
+	template <::std::size_t Bytes>
+	inline constexpr ::std::uint64_t key_hash_read(const char* str) {
+		::std::uint64_t word = 0;
+		if (!::std::is_constant_evaluated() && ::std::endian::native == ::std::endian::little) {
+			::std::memcpy(&word, str, Bytes);
+			return word;
+		}
+		for (::std::size_t i = 0; i < Bytes; ++i) {
+			word |= ::std::uint64_t(static_cast<unsigned char>(str[i])) << (i * 8);
+		}
+		return word;
+	}
+
+	// load 0~8 bytes without reading past the key (overlapping reads like wyhash)
+	inline constexpr ::std::uint64_t key_hash_load(const char* str, ::std::size_t length) {
+		if (length >= 8) {
+			return key_hash_read<8>(str);
+		}
+		if (length >= 4) {
+			return key_hash_read<4>(str) | (key_hash_read<4>(str + length - 4) << 32);
+		}
+		if (length > 0) {
+			return ::std::uint64_t(static_cast<unsigned char>(str[0])) |
+				(::std::uint64_t(static_cast<unsigned char>(str[length >> 1])) << 8) |
+				(::std::uint64_t(static_cast<unsigned char>(str[length - 1])) << 16);
+		}
+		return 0;
+	}
+
+	inline constexpr ::std::uint64_t key_hash(const char* str, ::std::size_t length, ::std::uint64_t seed) {
+		::std::uint64_t h = seed ^ (length * 0x9e3779b97f4a7c15ULL);
+		for (; length > 8; str += 8, length -= 8) {
+			h = key_hash_mix(h ^ key_hash_read<8>(str));
+		}
+		return key_hash_mix(h ^ key_hash_load(str, length));
+	}
+
+	// Perfect hash over N keys (hash and displace): one hash, one displacement, one compare per lookup
+	template <::std::size_t N>
+	struct key_index {
+		static constexpr ::std::size_t table_size = ::std::bit_ceil(N * 2 + 1);
+		static constexpr ::std::size_t mask = table_size - 1;
+
+		::std::uint64_t seed = 0;
+		::std::array<::std::uint64_t, table_size> displacement{};
+		::std::array<::std::uint16_t, table_size> slots{};
+		::std::array<::std::string_view, N> keys{};
+
+		// return key position, N if not found
+		constexpr ::std::size_t find(const char* str, ::std::size_t length) const {
+			if constexpr (N == 0) {
+				return 0;
+			}
+			else {
+				const ::std::uint64_t h = key_hash(str, length, seed);
+				const ::std::size_t pos = slots[key_hash_mix(h ^ displacement[h & mask]) & mask];
+				if (pos < N && keys[pos].size() == length &&
+					(length == 0 || ::std::char_traits<char>::compare(keys[pos].data(), str, length) == 0)) {
+					return pos;
+				}
+				return N;
+			}
+		}
+
+		constexpr ::std::size_t find(::std::string_view key) const {
+			return find(key.data(), key.size());
+		}
+	};
+
+	template <::std::size_t N>
+	consteval bool try_build_key_index(key_index<N>& index, ::std::uint64_t seed) {
+		using index_t = key_index<N>;
+		::std::array<::std::uint64_t, N> hashes{};
+		for (::std::size_t i = 0; i < N; ++i) {
+			hashes[i] = key_hash(index.keys[i].data(), index.keys[i].size(), seed);
+			for (::std::size_t j = 0; j < i; ++j) {
+				if (hashes[i] == hashes[j]) {
+					return false;
+				}
+			}
+		}
+
+		// place the largest buckets first, they are the hardest to displace
+		::std::array<::std::size_t, index_t::table_size> bucket_size{};
+		for (::std::size_t i = 0; i < N; ++i) {
+			++bucket_size[hashes[i] & index_t::mask];
+		}
+		::std::array<bool, index_t::table_size> used{};
+		index.slots.fill(static_cast<::std::uint16_t>(N));
+		for (::std::size_t size = N; size > 0; --size) {
+			for (::std::size_t bucket = 0; bucket < index_t::table_size; ++bucket) {
+				if (bucket_size[bucket] != size) {
+					continue;
+				}
+				bool placed = false;
+				for (::std::uint64_t d = 0; d < index_t::table_size * 64 && !placed; ++d) {
+					placed = true;
+					::std::array<::std::size_t, N> taken{};
+					::std::size_t count = 0;
+					for (::std::size_t i = 0; i < N && placed; ++i) {
+						if ((hashes[i] & index_t::mask) != bucket) {
+							continue;
+						}
+						const ::std::size_t slot = key_hash_mix(hashes[i] ^ d) & index_t::mask;
+						for (::std::size_t k = 0; k < count; ++k) {
+							placed = placed && taken[k] != slot;
+						}
+						placed = placed && !used[slot];
+						taken[count++] = slot;
+					}
+					if (placed) {
+						index.displacement[bucket] = d;
+						count = 0;
+						for (::std::size_t i = 0; i < N; ++i) {
+							if ((hashes[i] & index_t::mask) == bucket) {
+								used[taken[count++]] = true;
+								index.slots[key_hash_mix(hashes[i] ^ d) & index_t::mask] = static_cast<::std::uint16_t>(i);
+							}
+						}
+					}
+				}
+				if (!placed) {
+					return false;
+				}
+			}
+		}
+		index.seed = seed;
+		return true;
+	}
+
+	template <::std::size_t N>
+	consteval key_index<N> make_key_index(const ::std::array<::std::string_view, N>& keys) {
+		key_index<N> index{};
+		index.keys = keys;
+		if constexpr (N > 0) {
+			for (::std::uint64_t seed = 0;; ++seed) {
+				if (try_build_key_index(index, seed)) {
+					break;
+				}
+			}
+		}
+		return index;
+	}
+
+	// key index of serializable members, position i is the i-th index in serializable_indices_t<T>
+	template <typename T, ::std::size_t... Is>
+	consteval auto make_member_key_index(::std::index_sequence<Is...>) {
+		constexpr auto member_name_arr = struct_members_to_array<T>();
+		return make_key_index(::std::array<::std::string_view, sizeof...(Is)>{ member_name_arr[Is]... });
+	}
+
+	template <typename T>
+	inline constexpr auto member_key_index_v = make_member_key_index<remove_cvref_t<T>>(serializable_indices_t<remove_cvref_t<T>>{});
+
+}  // end namespace tinyrefl::detail
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+namespace tinyrefl::detail {
+
+	// 0 picks one worker per hardware thread
+	inline unsigned resolve_threads(unsigned threads) {
+		if (threads == 0) {
+			threads = ::std::thread::hardware_concurrency();
+		}
+		return ::std::max(threads, 1u);
+	}
+
+	// Runs task(i) for every i in [0, count) on up to threads workers, the calling thread
+	// being one of them. Workers pull the next index from a shared counter, so uneven
+	// chunks balance out. Returns once every task has finished.
+	template <typename Task>
+	void parallel_for(::std::size_t count, unsigned threads, Task&& task) {
+		::std::atomic<::std::size_t> next{0};
+		auto worker = [&] {
+			for (::std::size_t i = next++; i < count; i = next++) {
+				task(i);
+			}
+		};
+
+		const auto helpers = static_cast<::std::size_t>(resolve_threads(threads)) - 1;
+		::std::vector<::std::thread> pool;
+		pool.reserve(::std::min(helpers, count));
+		for (::std::size_t i = 0; i < helpers && i + 1 < count; ++i) {
+			pool.emplace_back(worker);
+		}
+		worker();
+		for (::std::thread& thread : pool) {
+			thread.join();
+		}
+	}
+
+}  // end namespace tinyrefl::detail
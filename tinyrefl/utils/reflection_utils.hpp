@@ -43,6 +43,10 @@ namespace tinyrefl::detail {
 	template <typename T>
 	inline constexpr bool is_string_v = is_template_instant_of<::std::basic_string, remove_cvref_t<T>>::value;
 
+	// Check is string_view
+	template <typename T>
+	inline constexpr bool is_string_view_v = is_template_instant_of<::std::basic_string_view, remove_cvref_t<T>>::value;
+
 	// Check is array
 	template <typename T>
 	inline constexpr bool is_array_v = ::std::is_array_v<remove_cvref_t<T>>;
@@ -188,6 +192,7 @@ namespace tinyrefl::detail {
 	inline constexpr bool is_custom_type_v = !is_sequence_container_v<remove_cvref_t<T>> &&
 		!is_associative_container_v<remove_cvref_t<T>> &&
 		!is_string_v<remove_cvref_t<T>> &&
+		!is_string_view_v<remove_cvref_t<T>> &&
 		!is_char_v<remove_cvref_t<T>> &&
 		!is_char_pointer_v<remove_cvref_t<T>> &&
 		!is_array_v<remove_cvref_t<T>> &&
@@ -200,7 +205,7 @@ namespace tinyrefl::detail {
 
 	template <typename T>
 	struct sequence_element_type_impl {
-		static_assert(false, "sequence_element_type just be use in sequence container type!");
+		static_assert(sizeof(T) == 0, "sequence_element_type just be use in sequence container type!");
 	};
 
 	template <template <typename, typename...> class Container, typename T, typename... Args>